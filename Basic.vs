@@ -4,11 +4,10 @@ layout(location = 1) in vec3 color;
 
 out vec3 fragColor;
 
-uniform mat4 model;
-uniform mat4 view;
-uniform mat4 projection;
+#include "Camera.glsl"
+#include "Object.glsl"
 
 void main() {
-    gl_Position = projection * view * model * vec4(position, 1.0);
+    gl_Position = viewProjection * model * vec4(position, 1.0);
     fragColor = color;
-}
+}
\ No newline at end of file
@@ -0,0 +1,505 @@
+#include "Benchmark.h"
+#include "MathUtils.h"
+#include "Instances.h"
+#include "JobSystem.h"
+#include "RenderQueue.h"
+#include "Culling.h"
+#include "MeshFile.h"
+#include <algorithm>
+#include <iomanip>
+#include <cmath>
+#include <cstring>
+#include <random>
+
+// glm avec ses intrinsics, pour comparer avec multiplyMat4
+#define GLM_FORCE_INTRINSICS
+#include <glm/glm.hpp>
+#include <glm/gtc/type_ptr.hpp>
+#if GLM_ARCH & GLM_ARCH_SSE2_BIT
+#include <glm/simd/matrix.h>
+#endif
+
+FrameBenchmark frameBenchmark;
+
+FrameBenchmark::FrameBenchmark() : m_DrawCalls(0), m_Instances(0), m_FenceWaitMs(0.0), m_StateIssued(0), m_StateElided(0), m_Culled(0), m_Triangles(0), m_TrianglesCulled(0), m_TrianglesUnknown(false), m_OcclusionTested(0), m_Occluded(0),
+    m_OcclusionMs(0.0) {}
+
+void FrameBenchmark::BeginFrame() {
+    m_DrawCalls = 0;
+    m_Instances = 0;
+    m_FenceWaitMs = 0.0;
+    m_StateIssued = 0;
+    m_StateElided = 0;
+    m_Culled = 0;
+    m_Triangles = 0;
+    m_TrianglesCulled = 0;
+    m_TrianglesUnknown = false;
+    m_OcclusionTested = 0;
+    m_Occluded = 0;
+    m_OcclusionMs = 0.0;
+    m_FrameStart = Clock::now();
+}
+
+void FrameBenchmark::EndFrame() {
+    std::chrono::duration<double, std::milli> elapsed = Clock::now() - m_FrameStart;
+    m_Samples.push_back({ elapsed.count(), m_DrawCalls, m_Instances, m_FenceWaitMs, m_StateIssued, m_StateElided, m_Culled, m_Triangles, m_TrianglesCulled,
+        m_TrianglesUnknown, m_OcclusionTested, m_Occluded, m_OcclusionMs });
+}
+
+// noms des passes GPU dans l'ordre de premiere apparition
+static std::vector<const char*> collectPassNames(const std::vector<GpuFrameTiming>& frames) {
+    std::vector<const char*> names;
+    for (const GpuFrameTiming& frame : frames) {
+        for (const GpuPassTiming& pass : frame.passes) {
+            bool known = false;
+            for (const char* name : names) known = known || strcmp(name, pass.name) == 0;
+            if (!known) names.push_back(pass.name);
+        }
+    }
+    return names;
+}
+
+double FrameBenchmark::Percentile(const std::vector<double>& sorted, double p) {
+    if (sorted.empty()) return 0.0;
+    // rang le plus proche, pas d'interpolation
+    size_t rank = (size_t)(p / 100.0 * (sorted.size() - 1) + 0.5);
+    return sorted[std::min(rank, sorted.size() - 1)];
+}
+
+void FrameBenchmark::Report(std::ostream& out, bool perFrame) const {
+    if (m_Samples.empty()) {
+        out << "No frame recorded" << std::endl;
+        return;
+    }
+
+    std::vector<double> times;
+    times.reserve(m_Samples.size());
+    double total = 0.0;
+    uint64_t drawCalls = 0, instances = 0;
+    double fenceWait = 0.0, maxFenceWait = 0.0;
+    uint64_t stateIssued = 0, stateElided = 0, culled = 0, triangles = 0, trianglesCulled = 0;
+    uint64_t occlusionTested = 0, occluded = 0;
+    double occlusionMs = 0.0;
+    bool trianglesUnknown = false;
+    for (const FrameSample& sample : m_Samples) {
+        times.push_back(sample.cpuMs);
+        total += sample.cpuMs;
+        drawCalls += sample.drawCalls;
+        instances += sample.instances;
+        fenceWait += sample.fenceWaitMs;
+        maxFenceWait = std::max(maxFenceWait, sample.fenceWaitMs);
+        stateIssued += sample.stateIssued;
+        stateElided += sample.stateElided;
+        culled += sample.culled;
+        triangles += sample.triangles;
+        trianglesCulled += sample.trianglesCulled;
+        trianglesUnknown = trianglesUnknown || sample.trianglesUnknown;
+        occlusionTested += sample.occlusionTested;
+        occluded += sample.occluded;
+        occlusionMs += sample.occlusionMs;
+    }
+    std::sort(times.begin(), times.end());
+
+    // frames GPU relues, rangees par numero de frame (vides si la mesure n'est pas revenue)
+    std::vector<const char*> passNames = collectPassNames(m_GpuFrames);
+    std::vector<const GpuFrameTiming*> gpuFrames(m_Samples.size(), nullptr);
+    for (const GpuFrameTiming& frame : m_GpuFrames) {
+        if (frame.frame < gpuFrames.size()) gpuFrames[frame.frame] = &frame;
+    }
+
+    out << std::fixed << std::setprecision(3);
+    if (perFrame) {
+        out << "frame,cpu_ms,draw_calls,instances,fence_wait_ms,state_issued,state_elided,culled,triangles,triangles_culled,occluded,occlusion_ms";
+        if (!m_GpuFrames.empty()) {
+            out << ",gpu_ms";
+            for (const char* name : passNames) out << ",gpu_" << name << "_ms";
+        }
+        out << std::endl;
+        for (size_t i = 0; i < m_Samples.size(); i++) {
+            out << i << "," << m_Samples[i].cpuMs << "," << m_Samples[i].drawCalls << "," << m_Samples[i].instances << "," << m_Samples[i].fenceWaitMs
+                << "," << m_Samples[i].stateIssued << "," << m_Samples[i].stateElided << "," << m_Samples[i].culled << ",";
+            // colonnes vides quand les triangles dessines ne sont connus que du GPU
+            if (!m_Samples[i].trianglesUnknown) out << m_Samples[i].triangles << "," << m_Samples[i].trianglesCulled;
+            else out << ",";
+            out << "," << m_Samples[i].occluded << "," << m_Samples[i].occlusionMs;
+            if (!m_GpuFrames.empty()) {
+                const GpuFrameTiming* frame = gpuFrames[i];
+                out << ",";
+                if (frame) out << frame->ms;
+                for (const char* name : passNames) {
+                    out << ",";
+                    if (!frame) continue;
+                    double ms = 0.0;
+                    for (const GpuPassTiming& pass : frame->passes) ms += strcmp(pass.name, name) == 0 ? pass.ms : 0.0;
+                    out << ms;
+                }
+            }
+            out << std::endl;
+        }
+    }
+
+    out << "frames      : " << m_Samples.size() << std::endl;
+    out << "cpu avg ms  : " << total / m_Samples.size() << std::endl;
+    out << "cpu min ms  : " << times.front() << std::endl;
+    out << "cpu p50 ms  : " << Percentile(times, 50.0) << std::endl;
+    out << "cpu p95 ms  : " << Percentile(times, 95.0) << std::endl;
+    out << "cpu p99 ms  : " << Percentile(times, 99.0) << std::endl;
+    out << "cpu max ms  : " << times.back() << std::endl;
+    out << "draws/frame : " << (double)drawCalls / m_Samples.size() << std::endl;
+    out << "fences ms   : " << fenceWait << " au total, " << maxFenceWait << " max" << std::endl;
+    out << "etats/frame : " << (double)stateIssued / m_Samples.size() << " emis, " << (double)stateElided / m_Samples.size() << " evites" << std::endl;
+    if (trianglesUnknown) out << "tris/frame  : n/d (commandes indirectes ecrites par le culling GPU)" << std::endl;
+    else out << "tris/frame  : " << (double)triangles / m_Samples.size() << std::endl;
+    if (trianglesCulled && !trianglesUnknown) out << "tris elim.  : " << 100.0 * trianglesCulled / (triangles + trianglesCulled) << " % (clusters hors champ ou de dos)" << std::endl;
+    if (culled) out << "elimines    : " << (double)culled / m_Samples.size() << " objets/frame" << std::endl;
+    if (occlusionTested) {
+        out << "occultes    : " << (double)occluded / m_Samples.size() << " objets/frame (" << 100.0 * occluded / occlusionTested
+            << " % des objets dans le champ), " << occlusionMs / m_Samples.size() << " ms CPU/frame" << std::endl;
+    }
+    if (!m_GpuFrames.empty()) {
+        std::vector<double> gpuTimes;
+        for (const GpuFrameTiming& frame : m_GpuFrames) gpuTimes.push_back(frame.ms);
+        std::sort(gpuTimes.begin(), gpuTimes.end());
+        double gpuTotal = 0.0;
+        for (double ms : gpuTimes) gpuTotal += ms;
+        out << "gpu avg ms  : " << gpuTotal / gpuTimes.size() << " (" << gpuTimes.size() << " frames relues), p50 " << Percentile(gpuTimes, 50.0)
+            << ", p95 " << Percentile(gpuTimes, 95.0) << ", max " << gpuTimes.back() << std::endl;
+
+        // moyennes par frame relue ; une passe absente d'une frame y compte pour 0
+        for (const char* name : passNames) {
+            double ms = 0.0;
+            uint64_t statistics[GPU_STAT_COUNT] = {};
+            for (const GpuFrameTiming& frame : m_GpuFrames) {
+                for (const GpuPassTiming& pass : frame.passes) {
+                    if (strcmp(pass.name, name) != 0) continue;
+                    ms += pass.ms;
+                    for (int stat = 0; stat < GPU_STAT_COUNT; stat++) statistics[stat] += pass.statistics[stat];
+                }
+            }
+            double frames = (double)m_GpuFrames.size();
+            out << "  " << std::left << std::setw(10) << name << std::right << ": " << ms / frames << " ms GPU";
+            if (statistics[GPU_STAT_VERTICES] || statistics[GPU_STAT_PRIMITIVES] || statistics[GPU_STAT_FRAGMENTS]) {
+                out << std::setprecision(0) << ", " << statistics[GPU_STAT_VERTICES] / frames << " vertex, " << statistics[GPU_STAT_PRIMITIVES] / frames
+                    << " primitives, " << statistics[GPU_STAT_FRAGMENTS] / frames << " fragments" << std::setprecision(3);
+            }
+            out << std::endl;
+        }
+    }
+    if (instances) {
+        out << "instances/s : " << std::setprecision(0) << instances / (total / 1000.0) << std::setprecision(3) << std::endl;
+    }
+}
+
+// mesure le temps moyen d'un appel de fn en nanosecondes
+template<typename Fn>
+static double TimeNs(size_t iterations, Fn fn) {
+    auto start = std::chrono::steady_clock::now();
+    for (size_t i = 0; i < iterations; i++) fn(i);
+    std::chrono::duration<double, std::nano> elapsed = std::chrono::steady_clock::now() - start;
+    return elapsed.count() / iterations;
+}
+
+static float MaxDifference(const Mat4& a, const Mat4& b) {
+    float difference = 0.0f;
+    for (int i = 0; i < 16; i++) difference = std::max(difference, std::fabs(a.data[i] - b.data[i]));
+    return difference;
+}
+
+void RunMathBenchmark(std::ostream& out) {
+    const size_t iterations = 20000000;
+    const size_t batchCount = 100000;
+    const int batchRepeats = 50;
+
+    std::vector<Mat4> matrices(256);
+    for (size_t i = 0; i < matrices.size(); i++) {
+        float angle = 0.01f * i;
+        matrices[i] = multiplyMat4Scalar(multiplyMat4Scalar(rotateX(angle), rotateY(angle * 0.5f)), translate(angle, -angle, 2.0f * angle));
+    }
+
+    // verification : toutes les versions donnent le meme resultat (glm calcule b * a pour multiplyMat4(a, b))
+    Mat4 reference = multiplyMat4Scalar(matrices[3], matrices[7]);
+    Mat4 simd = multiplyMat4(matrices[3], matrices[7]);
+    glm::mat4 glmA = glm::make_mat4(matrices[3].data);
+    glm::mat4 glmB = glm::make_mat4(matrices[7].data);
+    Mat4 glmResult;
+    glm::mat4 glmProduct = glmB * glmA;
+    std::copy(glm::value_ptr(glmProduct), glm::value_ptr(glmProduct) + 16, glmResult.data);
+
+    out << std::fixed << std::setprecision(2);
+    out << "chemin SIMD : " << mathSimdName() << std::endl;
+    out << "ecart SIMD/scalaire : " << std::scientific << MaxDifference(reference, simd)
+        << ", glm/scalaire : " << MaxDifference(reference, glmResult) << std::fixed << std::endl;
+
+    // dependance entre iterations pour que le compilateur ne supprime rien
+    Mat4 accumulator = identityMatrix();
+    double scalarNs = TimeNs(iterations, [&](size_t i) {
+        accumulator = multiplyMat4Scalar(accumulator, matrices[i & 255]);
+    });
+    float sink = accumulator.data[0];
+
+    accumulator = identityMatrix();
+    double simdNs = TimeNs(iterations, [&](size_t i) {
+        accumulator = multiplyMat4(accumulator, matrices[i & 255]);
+    });
+    sink += accumulator.data[0];
+
+    std::vector<glm::mat4> glmMatrices(matrices.size());
+    for (size_t i = 0; i < matrices.size(); i++) glmMatrices[i] = glm::make_mat4(matrices[i].data);
+    glm::mat4 glmAccumulator(1.0f);
+    double glmNs = TimeNs(iterations, [&](size_t i) {
+        glmAccumulator = glmMatrices[i & 255] * glmAccumulator;
+    });
+    sink += glmAccumulator[0][0];
+
+    out << "latence d'une chaine de produits dependants :" << std::endl;
+    out << "multiplyMat4 scalaire : " << scalarNs << " ns" << std::endl;
+    out << "multiplyMat4 SIMD    : " << simdNs << " ns (x" << scalarNs / simdNs << ")" << std::endl;
+    out << "glm::mat4 operator*  : " << glmNs << " ns (x" << scalarNs / glmNs << ")" << std::endl;
+
+#if GLM_ARCH & GLM_ARCH_SSE2_BIT
+    glm_vec4 glmIn[4], glmOut[4];
+    for (int c = 0; c < 4; c++) glmOut[c] = _mm_loadu_ps(&matrices[0].data[c * 4]);
+    double glmSimdNs = TimeNs(iterations, [&](size_t i) {
+        for (int c = 0; c < 4; c++) glmIn[c] = glmOut[c];
+        glm_mat4_mul((const glm_vec4*)glmMatrices[i & 255][0].data.data, glmIn, glmOut);
+    });
+    sink += _mm_cvtss_f32(glmOut[0]);
+    out << "glm_mat4_mul (SSE)   : " << glmSimdNs << " ns (x" << scalarNs / glmSimdNs << ")" << std::endl;
+#endif
+
+    // transformations par lots (debit)
+    std::vector<Vec4> vectors(batchCount);
+    for (size_t i = 0; i < batchCount; i++) vectors[i] = { (float)i, 1.0f, -(float)i, 1.0f };
+    std::vector<Vec4> transformed(batchCount);
+    std::vector<Mat4> batchOutput(batchCount);
+    std::vector<Mat4> batchInput(batchCount);
+    for (size_t i = 0; i < batchCount; i++) batchInput[i] = matrices[i & 255];
+
+    double vecScalarNs = TimeNs(batchRepeats, [&](size_t) {
+        for (size_t i = 0; i < batchCount; i++) {
+            const float* c = matrices[1].data;
+            const Vec4& v = vectors[i];
+            transformed[i] = { c[0] * v.x + c[4] * v.y + c[8] * v.z + c[12] * v.w,
+                c[1] * v.x + c[5] * v.y + c[9] * v.z + c[13] * v.w,
+                c[2] * v.x + c[6] * v.y + c[10] * v.z + c[14] * v.w,
+                c[3] * v.x + c[7] * v.y + c[11] * v.z + c[15] * v.w };
+        }
+    }) / batchCount;
+    sink += transformed[batchCount / 2].x;
+    double vecBatchNs = TimeNs(batchRepeats, [&](size_t) {
+        transformVec4Batch(matrices[1], vectors.data(), transformed.data(), batchCount);
+    }) / batchCount;
+    sink += transformed[batchCount / 2].x;
+
+    double matScalarNs = TimeNs(batchRepeats, [&](size_t) {
+        for (size_t i = 0; i < batchCount; i++) batchOutput[i] = multiplyMat4Scalar(batchInput[i], matrices[1]);
+    }) / batchCount;
+    sink += batchOutput[batchCount / 2].data[0];
+    double matBatchNs = TimeNs(batchRepeats, [&](size_t) {
+        multiplyMat4Batch(batchInput.data(), matrices[1], batchOutput.data(), batchCount);
+    }) / batchCount;
+    sink += batchOutput[batchCount / 2].data[0];
+
+    out << "transformVec4 scalaire / lot : " << vecScalarNs << " / " << vecBatchNs << " ns par vecteur (x" << vecScalarNs / vecBatchNs << ")" << std::endl;
+    out << "multiplyMat4 scalaire / lot  : " << matScalarNs << " / " << matBatchNs << " ns par matrice (x" << matScalarNs / matBatchNs << ")" << std::endl;
+    out << "(controle " << sink << ")" << std::endl;
+}
+
+void RunJobBenchmark(std::ostream& out, uint32_t instanceCount, uint32_t maxThreads) {
+    const int repeats = 50;
+    const size_t grain = 512;
+    if (maxThreads == 0) maxThreads = std::max(1u, std::thread::hardware_concurrency());
+
+    InstanceSet instances;
+    instances.Generate(instanceCount, 4.0f);
+    std::vector<Mat4> models(instances.GetCount());
+    Mat4 baseModel = identityMatrix();
+
+    out << std::fixed << std::setprecision(3);
+    out << instances.GetCount() << " instances, lots de " << grain << ", " << repeats << " frames" << std::endl;
+    out << "threads,ms_par_frame,acceleration,efficacite" << std::endl;
+
+    double singleMs = 0.0;
+    float sink = 0.0f;
+    for (uint32_t threads = 1; threads <= maxThreads; threads++) {
+        JobSystem jobs;
+        jobs.Initialize(threads);
+        double ms = TimeNs(repeats, [&](size_t frame) {
+            jobs.ParallelFor(models.size(), grain, [&](size_t begin, size_t end) {
+                instances.Update(frame / 60.0f, baseModel, models.data(), begin, end);
+            });
+        }) / 1e6;
+        sink += models[models.size() / 2].data[0];
+        if (threads == 1) singleMs = ms;
+        out << threads << "," << ms << "," << singleMs / ms << "," << singleMs / ms / threads << std::endl;
+    }
+    out << "(controle " << sink << ")" << std::endl;
+}
+
+void RunQueueBenchmark(std::ostream& out, uint32_t packetCount) {
+    const int repeats = 50;
+    const uint32_t programCount = 16;
+    const uint32_t materialCount = 256;
+
+    // cles d'une scene typique : 16 programmes, 256 materiaux, profondeurs aleatoires, 10 % de transparents
+    std::mt19937 random(1234);
+    std::uniform_real_distribution<float> depth(0.1f, 1000.0f);
+    std::vector<uint64_t> keys(packetCount);
+    for (uint64_t& key : keys) {
+        RenderPass pass = random() % 10 == 0 ? RENDER_PASS_TRANSPARENT : RENDER_PASS_OPAQUE;
+        key = makeSortKey(pass, random() % programCount, random() % materialCount, depth(random));
+    }
+
+    RenderQueue queue;
+    queue.Reserve(packetCount);
+    DrawPacket packet = {};
+    double submitMs = TimeNs(repeats, [&](size_t) {
+        queue.Clear();
+        for (uint64_t key : keys) queue.Submit(key, packet);
+    }) / 1e6;
+    double radixMs = TimeNs(repeats, [&](size_t) {
+        queue.Clear();
+        for (uint64_t key : keys) queue.Submit(key, packet);
+        queue.Sort();
+    }) / 1e6 - submitMs;
+
+    bool sorted = true;
+    for (size_t i = 1; i < queue.GetCount(); i++) {
+        sorted = sorted && queue.GetKey(i - 1) <= queue.GetKey(i);
+    }
+
+    // changements de programme avant / apres tri (champ programme des cles opaques)
+    auto countProgramChanges = [&](auto getKey) {
+        uint32_t changes = 0;
+        for (size_t i = 1; i < packetCount; i++) changes += ((getKey(i - 1) ^ getKey(i)) >> SORT_KEY_PROGRAM_SHIFT & 0xFFF) != 0;
+        return changes;
+    };
+    uint32_t unsortedChanges = countProgramChanges([&](size_t i) { return keys[i]; });
+    uint32_t programChanges = countProgramChanges([&](size_t i) { return queue.GetKey(i); });
+
+    std::vector<uint64_t> copy;
+    double stdMs = TimeNs(repeats, [&](size_t) {
+        copy = keys;
+        std::sort(copy.begin(), copy.end());
+    }) / 1e6;
+
+    out << std::fixed << std::setprecision(3);
+    out << packetCount << " paquets, " << repeats << " frames" << std::endl;
+    out << "soumission         : " << submitMs << " ms" << std::endl;
+    out << "tri radix          : " << radixMs << " ms" << (sorted ? "" : " (ERREUR : ordre incorrect)") << std::endl;
+    out << "std::sort des cles : " << stdMs << " ms" << std::endl;
+    out << "changements de programme : " << unsortedChanges << " -> " << programChanges << std::endl;
+}
+
+void RunCullBenchmark(std::ostream& out, uint32_t objectCount) {
+    const int repeats = 20;
+
+    // spheres aleatoires dans un cube de 200 de cote, camera au centre regardant vers -Z
+    std::mt19937 random(1234);
+    std::uniform_real_distribution<float> position(-100.0f, 100.0f);
+    std::uniform_real_distribution<float> radius(0.5f, 2.0f);
+    SphereBounds bounds;
+    for (uint32_t i = 0; i < objectCount; i++) {
+        bounds.Add({ position(random), position(random), position(random) }, radius(random));
+    }
+    Frustum frustum = extractFrustum(perspective(45.0f * (3.14159f / 180.0f), 16.0f / 9.0f, 0.1f, 150.0f));
+
+    std::vector<uint32_t> visibleScalar(objectCount), visibleSimd(objectCount);
+    size_t scalarCount = 0, simdCount = 0;
+    double scalarMs = TimeNs(repeats, [&](size_t) { scalarCount = cullSpheresScalar(frustum, bounds, visibleScalar.data()); }) / 1e6;
+    double simdMs = TimeNs(repeats, [&](size_t) { simdCount = cullSpheres(frustum, bounds, visibleSimd.data()); }) / 1e6;
+    bool identical = scalarCount == simdCount && std::equal(visibleScalar.begin(), visibleScalar.begin() + scalarCount, visibleSimd.begin());
+
+    out << std::fixed << std::setprecision(3);
+    out << objectCount << " spheres, " << 100.0 * simdCount / objectCount << " % visibles" << std::endl;
+    out << "scalaire : " << scalarMs << " ms (" << objectCount / scalarMs / 1000.0 << " M objets/s)" << std::endl;
+    out << "SIMD " << mathSimdName() << " : " << simdMs << " ms (" << objectCount / simdMs / 1000.0
+        << " M objets/s, x" << scalarMs / simdMs << ")" << (identical ? "" : " (ERREUR : resultats differents)") << std::endl;
+}
+
+void RunClusterBenchmark(std::ostream& out, const char* meshPath) {
+    MeshFile file;
+    if (!file.Open(meshPath)) {
+        out << "Impossible d'ouvrir " << meshPath << std::endl;
+        return;
+    }
+    const MeshFileHeader& header = file.GetHeader();
+    if (!header.clusterCount) {
+        out << meshPath << " n'a pas de clusters (version " << header.version << "), relancer MeshConverter" << std::endl;
+        return;
+    }
+
+    ClusterBounds bounds;
+    const MeshCluster* clusters = file.GetClusters();
+    uint64_t totalTriangles = 0;
+    for (uint32_t i = 0; i < header.clusterCount; i++) {
+        const MeshCluster& c = clusters[i];
+        bounds.Add({ c.center[0], c.center[1], c.center[2] }, c.radius, { c.coneApex[0], c.coneApex[1], c.coneApex[2] },
+            { c.coneAxis[0], c.coneAxis[1], c.coneAxis[2] }, c.coneCutoff);
+        totalTriangles += c.indexCount / 3;
+    }
+    float center[3], radius = 0.0f;
+    for (int axis = 0; axis < 3; axis++) {
+        center[axis] = 0.5f * (header.boundsMin[axis] + header.boundsMax[axis]);
+        float extent = 0.5f * (header.boundsMax[axis] - header.boundsMin[axis]);
+        radius += extent * extent;
+    }
+    radius = sqrtf(radius);
+
+    // orbites autour du centre : 36 azimuts x 4 elevations x 3 distances (de pres, cadre, de loin)
+    const float fov = 45.0f * (3.14159f / 180.0f);
+    const float framing = 1.0f / sinf(fov / 2.0f);
+    const float distances[] = { 0.5f * framing, framing, 2.5f * framing };
+    const float elevations[] = { -30.0f, 0.0f, 30.0f, 60.0f };
+    std::vector<Frustum> frustums;
+    std::vector<Vec3> cameras;
+    for (float distance : distances) {
+        for (float elevation : elevations) {
+            for (int azimuth = 0; azimuth < 360; azimuth += 10) {
+                Mat4 orbit = multiplyMat4(rotateY(azimuth * (3.14159f / 180.0f)), rotateX(elevation * (3.14159f / 180.0f)));
+                Mat4 view = multiplyMat4(multiplyMat4(translate(-center[0], -center[1], -center[2]), orbit), translate(0.0f, 0.0f, -distance * radius));
+                Mat4 projection = perspective(fov, 4.0f / 3.0f, 0.01f * radius, (distance + 2.0f) * radius);
+                frustums.push_back(extractFrustum(multiplyMat4(view, projection)));
+                cameras.push_back(extractCameraPosition(view));
+            }
+        }
+    }
+
+    // plans toujours satisfaits : seul le cone rejette
+    Frustum everything;
+    for (Vec4& plane : everything.planes) plane = { 0.0f, 0.0f, 0.0f, 1.0f };
+
+    std::vector<uint32_t> visible(bounds.GetCount());
+    auto culledTriangles = [&](size_t visibleCount) {
+        uint64_t kept = 0;
+        for (size_t i = 0; i < visibleCount; i++) kept += clusters[visible[i]].indexCount / 3;
+        return totalTriangles - kept;
+    };
+    uint64_t frustumCulled = 0, coneCulled = 0, bothCulled = 0;
+    for (size_t v = 0; v < frustums.size(); v++) {
+        frustumCulled += culledTriangles(cullSpheres(frustums[v], bounds.GetSpheres(), visible.data()));
+        coneCulled += culledTriangles(cullClusters(everything, cameras[v], bounds, visible.data()));
+        bothCulled += culledTriangles(cullClusters(frustums[v], cameras[v], bounds, visible.data()));
+    }
+
+    const int repeats = 20;
+    std::vector<uint32_t> visibleScalar(bounds.GetCount()), visibleSimd(bounds.GetCount());
+    bool identical = true;
+    for (size_t v = 0; v < frustums.size(); v++) {
+        size_t scalarCount = cullClustersScalar(frustums[v], cameras[v], bounds, visibleScalar.data());
+        size_t simdCount = cullClusters(frustums[v], cameras[v], bounds, visibleSimd.data());
+        identical = identical && scalarCount == simdCount && std::equal(visibleScalar.begin(), visibleScalar.begin() + scalarCount, visibleSimd.begin());
+    }
+    size_t iterations = repeats * frustums.size();
+    double scalarUs = TimeNs(iterations, [&](size_t r) { cullClustersScalar(frustums[r % frustums.size()], cameras[r % frustums.size()], bounds, visibleScalar.data()); }) / 1e3;
+    double simdUs = TimeNs(iterations, [&](size_t r) { cullClusters(frustums[r % frustums.size()], cameras[r % frustums.size()], bounds, visibleSimd.data()); }) / 1e3;
+
+    double views = (double)frustums.size() * totalTriangles;
+    out << std::fixed << std::setprecision(3);
+    out << meshPath << " : " << header.clusterCount << " clusters, " << totalTriangles << " triangles au niveau 0, " << frustums.size() << " points de vue" << std::endl;
+    out << "triangles elimines : frustum " << 100.0 * frustumCulled / views << " %, cone " << 100.0 * coneCulled / views
+        << " %, les deux " << 100.0 * bothCulled / views << " %" << std::endl;
+    out << "scalaire : " << scalarUs << " us par vue" << std::endl;
+    out << "SIMD " << mathSimdName() << " : " << simdUs << " us par vue (x" << scalarUs / simdUs << ")"
+        << (identical ? "" : " (ERREUR : resultats differents)") << std::endl;
+}
@@ -0,0 +1,86 @@
+#pragma once
+
+#include "GpuProfiler.h"
+#include <cstdint>
+#include <vector>
+#include <chrono>
+#include <iostream>
+
+// statistiques d'une frame mesuree par le harnais de benchmark
+struct FrameSample {
+    double cpuMs;
+    uint32_t drawCalls;
+    uint32_t instances;
+    double fenceWaitMs;    // attente CPU sur les fences du ring buffer
+    uint32_t stateIssued;  // changements d'etat transmis au driver
+    uint32_t stateElided;  // changements d'etat redondants evites par glState
+    uint32_t culled;       // objets elimines par le frustum culling
+    uint64_t triangles;    // triangles soumis, instances comprises (hors draws indirects)
+    uint64_t trianglesCulled;   // triangles elimines avec leur cluster (frustum et cone de normales)
+    bool trianglesUnknown;      // une partie des triangles dessines n'est connue que du GPU (culling GPU)
+    uint32_t occlusionTested;   // objets dans le champ soumis a l'occlusion culling
+    uint32_t occluded;          // objets caches par les occulteurs
+    double occlusionMs;         // rasterisation des occulteurs et tests, sur les threads du JobSystem
+};
+
+class FrameBenchmark {
+public:
+    FrameBenchmark();
+
+    void BeginFrame();
+    void EndFrame();
+    void CountDrawCall(uint32_t count = 1) { m_DrawCalls += count; }
+    void CountInstances(uint32_t count) { m_Instances += count; }
+    void AddFenceWait(double ms) { m_FenceWaitMs += ms; }
+    void CountStateChanges(uint32_t issued, uint32_t elided) { m_StateIssued += issued; m_StateElided += elided; }
+    void CountCulled(uint32_t count) { m_Culled += count; }
+    void CountTriangles(uint64_t count) { m_Triangles += count; }
+    void CountTrianglesCulled(uint64_t count) { m_TrianglesCulled += count; }
+    void MarkTrianglesUnknown() { m_TrianglesUnknown = true; }
+    void CountOccluded(uint32_t tested, uint32_t occluded, double ms) { m_OcclusionTested += tested; m_Occluded += occluded; m_OcclusionMs += ms; }
+    // temps GPU relus par le GpuProfiler quelques frames apres coup, rattaches a leur frame par son numero
+    void AddGpuFrame(const GpuFrameTiming& timing) { m_GpuFrames.push_back(timing); }
+
+    size_t GetFrameCount() const { return m_Samples.size(); }
+    void Report(std::ostream& out, bool perFrame) const;
+
+private:
+    using Clock = std::chrono::steady_clock;
+
+    Clock::time_point m_FrameStart;
+    uint32_t m_DrawCalls;
+    uint32_t m_Instances;
+    double m_FenceWaitMs;
+    uint32_t m_StateIssued;
+    uint32_t m_StateElided;
+    uint32_t m_Culled;
+    uint64_t m_Triangles;
+    uint64_t m_TrianglesCulled;
+    bool m_TrianglesUnknown;
+    uint32_t m_OcclusionTested;
+    uint32_t m_Occluded;
+    double m_OcclusionMs;
+    std::vector<FrameSample> m_Samples;
+    std::vector<GpuFrameTiming> m_GpuFrames;
+
+    static double Percentile(const std::vector<double>& sorted, double p);
+};
+
+// instance globale utilisee par render() pour compter les draw calls
+extern FrameBenchmark frameBenchmark;
+
+// micro-benchmarks sans contexte GL (option --bench)
+void RunMathBenchmark(std::ostream& out);
+
+// mise a jour des matrices d'instances avec le JobSystem, de 1 a maxThreads threads (0 = tous les coeurs)
+void RunJobBenchmark(std::ostream& out, uint32_t instanceCount, uint32_t maxThreads);
+
+// soumission et tri par cle d'une RenderQueue, compare a std::sort
+void RunQueueBenchmark(std::ostream& out, uint32_t packetCount);
+
+// frustum culling de objectCount spheres en SoA, version SIMD contre version scalaire
+void RunCullBenchmark(std::ostream& out, uint32_t objectCount);
+
+// culling par cluster d'un mesh (version 3) sur des orbites de camera : part des triangles elimines
+// par le frustum, par le cone de normales et au total, version SIMD contre version scalaire
+void RunClusterBenchmark(std::ostream& out, const char* meshPath);
@@ -0,0 +1,7 @@
+// bloc camera partage par tous les programmes (miroir de CameraBlock)
+layout(std140) uniform Camera {
+    mat4 view;
+    mat4 projection;
+    mat4 viewProjection;
+    float time;
+};
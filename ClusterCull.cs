@@ -0,0 +1,59 @@
+#version 430 core
+layout(local_size_x = 64) in;
+
+// un thread par cluster du dragon : une commande indirecte par cluster, instanceCount a 0
+// quand le cluster est hors du frustum ou entierement de dos
+
+struct DrawElementsIndirectCommand {
+    uint count;
+    uint instanceCount;
+    uint firstIndex;
+    int baseVertex;
+    uint baseInstance;
+};
+
+// miroir de GpuClusterData
+struct ClusterData {
+    vec4 sphere;          // centre, rayon
+    vec3 apex;
+    uint firstIndex;
+    vec4 cone;            // axe, cutoff^2
+    uint indexCount;
+    uint padding0, padding1, padding2;
+};
+
+layout(std430, binding = 0) readonly buffer Clusters { ClusterData clusters[]; };
+layout(std430, binding = 1) writeonly buffer Commands { DrawElementsIndirectCommand commands[]; };
+
+uniform vec4 frustumPlanes[6];   // espace objet
+uniform vec3 cameraPosition;     // espace objet
+uniform uint clusterCount;
+
+void main() {
+    uint i = gl_GlobalInvocationID.x;
+    if (i >= clusterCount) return;
+
+    // meme ordre d'evaluation que cullClusters, sans fusion en fma
+    ClusterData cluster = clusters[i];
+    vec4 sphere = cluster.sphere;
+    bool inside = true;
+    for (int p = 0; p < 6; p++) {
+        vec4 plane = frustumPlanes[p];
+        precise float distance = plane.x * sphere.x + (plane.y * sphere.y + (plane.z * sphere.z + (plane.w + sphere.w)));
+        inside = inside && distance >= 0.0;
+    }
+
+    // de dos : camera dans le cone oppose a celui des normales, de sommet apex
+    precise vec3 d = cluster.apex - cameraPosition;
+    precise float t = cluster.cone.x * d.x + (cluster.cone.y * d.y + cluster.cone.z * d.z);
+    precise float distanceSquared = d.x * d.x + (d.y * d.y + d.z * d.z);
+    precise float cutoffTerm = cluster.cone.w * distanceSquared;
+    precise float tSquared = t * t;
+    bool backFacing = t > 0.0 && tSquared >= cutoffTerm;
+
+    commands[i].count = cluster.indexCount;
+    commands[i].instanceCount = inside && !backFacing ? 1u : 0u;
+    commands[i].firstIndex = cluster.firstIndex;
+    commands[i].baseVertex = 0;
+    commands[i].baseInstance = 0;
+}
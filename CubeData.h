@@ -0,0 +1,22 @@
+#pragma once
+
+// format X,Y,Z, R,G,B = 6 floats par vertex
+const float cube_vertices[] = {
+    -1.0f, -1.0f,  1.0f,   1.0f, 0.0f, 0.0f,
+     1.0f, -1.0f,  1.0f,   0.0f, 1.0f, 0.0f,
+     1.0f,  1.0f,  1.0f,   0.0f, 0.0f, 1.0f,
+    -1.0f,  1.0f,  1.0f,   1.0f, 1.0f, 0.0f,
+    -1.0f, -1.0f, -1.0f,   1.0f, 0.0f, 1.0f,
+     1.0f, -1.0f, -1.0f,   0.0f, 1.0f, 1.0f,
+     1.0f,  1.0f, -1.0f,   0.5f, 0.5f, 0.5f,
+    -1.0f,  1.0f, -1.0f,   1.0f, 0.5f, 0.5f
+};
+
+const unsigned int cube_elements[] = {
+    0, 1, 2, 2, 3, 0,
+    1, 5, 6, 6, 2, 1,
+    7, 6, 5, 5, 4, 7,
+    4, 0, 3, 3, 7, 4,
+    4, 5, 1, 1, 0, 4,
+    3, 2, 6, 6, 7, 3
+};
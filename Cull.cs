@@ -0,0 +1,41 @@
+#version 430 core
+layout(local_size_x = 64) in;
+
+// un thread par instance : les spheres visibles ajoutent leur matrice a la liste compactee
+// et incrementent instanceCount de la commande indirecte
+
+struct DrawElementsIndirectCommand {
+    uint count;
+    uint instanceCount;
+    uint firstIndex;
+    int baseVertex;
+    uint baseInstance;
+};
+
+layout(std430, binding = 0) readonly buffer Bounds { vec4 bounds[]; };   // centre, rayon
+layout(std430, binding = 1) readonly buffer Models { mat4 models[]; };
+layout(std430, binding = 2) writeonly buffer VisibleModels { mat4 visibleModels[]; };
+layout(std430, binding = 3) writeonly buffer VisibleIndices { uint visibleIndices[]; };
+layout(std430, binding = 4) buffer Commands { DrawElementsIndirectCommand command; };
+
+uniform vec4 frustumPlanes[6];
+uniform uint objectCount;
+
+void main() {
+    uint i = gl_GlobalInvocationID.x;
+    if (i >= objectCount) return;
+
+    // meme ordre d'evaluation que cullSpheres, sans fusion en fma
+    vec4 sphere = bounds[i];
+    bool inside = true;
+    for (int p = 0; p < 6; p++) {
+        vec4 plane = frustumPlanes[p];
+        precise float distance = plane.x * sphere.x + (plane.y * sphere.y + (plane.z * sphere.z + (plane.w + sphere.w)));
+        inside = inside && distance >= 0.0;
+    }
+    if (!inside) return;
+
+    uint slot = atomicAdd(command.instanceCount, 1u);
+    visibleModels[slot] = models[i];
+    visibleIndices[slot] = i;
+}
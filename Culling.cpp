@@ -0,0 +1,330 @@
+#include "Culling.h"
+#include <cmath>
+#include <cfloat>
+
+#if defined(MATH_SIMD_SSE)
+#include <immintrin.h>
+#elif defined(MATH_SIMD_NEON)
+#include <arm_neon.h>
+#endif
+
+Frustum extractFrustum(const Mat4& viewProjection) {
+    // ligne r de la matrice (colonnes contigues)
+    const float* m = viewProjection.data;
+    auto row = [m](int r) { return Vec4{ m[r], m[4 + r], m[8 + r], m[12 + r] }; };
+    Vec4 w = row(3);
+
+    Frustum frustum;
+    for (int axis = 0; axis < 3; axis++) {
+        Vec4 r = row(axis);
+        frustum.planes[axis * 2] = { w.x + r.x, w.y + r.y, w.z + r.z, w.w + r.w };
+        frustum.planes[axis * 2 + 1] = { w.x - r.x, w.y - r.y, w.z - r.z, w.w - r.w };
+    }
+    // normalises pour que la distance au plan se compare directement au rayon
+    for (Vec4& plane : frustum.planes) {
+        float length = sqrtf(plane.x * plane.x + plane.y * plane.y + plane.z * plane.z);
+        plane = { plane.x / length, plane.y / length, plane.z / length, plane.w / length };
+    }
+    return frustum;
+}
+
+Vec3 extractCameraPosition(const Mat4& modelView) {
+    // camera en c tel que R c + t = 0, soit c = -R^T t (colonnes de R contigues)
+    const float* m = modelView.data;
+    return {
+        -(m[0] * m[12] + m[1] * m[13] + m[2] * m[14]),
+        -(m[4] * m[12] + m[5] * m[13] + m[6] * m[14]),
+        -(m[8] * m[12] + m[9] * m[13] + m[10] * m[14])
+    };
+}
+
+BoundingSphere computeBoundingSphere(const float* vertices, size_t vertexCount, size_t stride) {
+    BoundingSphere sphere = { { 0.0f, 0.0f, 0.0f }, 0.0f };
+    if (vertexCount == 0) return sphere;
+
+    float boundsMin[3] = { FLT_MAX, FLT_MAX, FLT_MAX };
+    float boundsMax[3] = { -FLT_MAX, -FLT_MAX, -FLT_MAX };
+    for (size_t i = 0; i < vertexCount; i++) {
+        const float* position = &vertices[i * stride];
+        for (int axis = 0; axis < 3; axis++) {
+            boundsMin[axis] = fminf(boundsMin[axis], position[axis]);
+            boundsMax[axis] = fmaxf(boundsMax[axis], position[axis]);
+        }
+    }
+    sphere.center = { 0.5f * (boundsMin[0] + boundsMax[0]), 0.5f * (boundsMin[1] + boundsMax[1]), 0.5f * (boundsMin[2] + boundsMax[2]) };
+
+    // rayon au vertex le plus eloigne, plus serre que la demi-diagonale de l'AABB
+    float radiusSquared = 0.0f;
+    for (size_t i = 0; i < vertexCount; i++) {
+        const float* position = &vertices[i * stride];
+        float dx = position[0] - sphere.center.x, dy = position[1] - sphere.center.y, dz = position[2] - sphere.center.z;
+        radiusSquared = fmaxf(radiusSquared, dx * dx + dy * dy + dz * dz);
+    }
+    sphere.radius = sqrtf(radiusSquared);
+    return sphere;
+}
+
+void SphereBounds::Clear() {
+    m_X.clear();
+    m_Y.clear();
+    m_Z.clear();
+    m_Radius.clear();
+    m_Count = 0;
+}
+
+void SphereBounds::Add(const Vec3& center, float radius) {
+    if (m_Count == m_X.size()) {
+        // un rayon de -FLT_MAX est toujours du mauvais cote d'un plan
+        size_t padded = m_Count + 8;
+        m_X.resize(padded, 0.0f);
+        m_Y.resize(padded, 0.0f);
+        m_Z.resize(padded, 0.0f);
+        m_Radius.resize(padded, -FLT_MAX);
+    }
+    m_X[m_Count] = center.x;
+    m_Y[m_Count] = center.y;
+    m_Z[m_Count] = center.z;
+    m_Radius[m_Count] = radius;
+    m_Count++;
+}
+
+size_t cullSpheresScalar(const Frustum& frustum, const SphereBounds& bounds, uint32_t* visible) {
+    const float *x = bounds.GetX(), *y = bounds.GetY(), *z = bounds.GetZ(), *radius = bounds.GetRadius();
+    size_t visibleCount = 0;
+    for (size_t i = 0; i < bounds.GetCount(); i++) {
+        bool inside = true;
+        for (const Vec4& plane : frustum.planes) {
+            // meme ordre d'evaluation que les versions SIMD
+            inside = inside && plane.x * x[i] + (plane.y * y[i] + (plane.z * z[i] + (plane.w + radius[i]))) >= 0.0f;
+        }
+        if (inside) visible[visibleCount++] = (uint32_t)i;
+    }
+    return visibleCount;
+}
+
+// ajoute a visible les indices base + bit des bits a 1 de mask
+static inline size_t compactMask(uint32_t mask, uint32_t base, uint32_t* visible, size_t visibleCount) {
+    while (mask) {
+        uint32_t bit = 0;
+        while (!(mask >> bit & 1)) bit++;
+        visible[visibleCount++] = base + bit;
+        mask &= mask - 1;
+    }
+    return visibleCount;
+}
+
+#if defined(MATH_SIMD_AVX)
+// plans du frustum diffuses sur 8 voies
+struct FrustumLanes {
+    __m256 x[6], y[6], z[6], w[6];
+};
+
+static inline FrustumLanes loadFrustumLanes(const Frustum& frustum) {
+    FrustumLanes lanes;
+    for (int p = 0; p < 6; p++) {
+        lanes.x[p] = _mm256_set1_ps(frustum.planes[p].x);
+        lanes.y[p] = _mm256_set1_ps(frustum.planes[p].y);
+        lanes.z[p] = _mm256_set1_ps(frustum.planes[p].z);
+        lanes.w[p] = _mm256_set1_ps(frustum.planes[p].w);
+    }
+    return lanes;
+}
+
+// distance signee au plan + rayon >= 0 pour les 6 plans
+static inline __m256 insideFrustum(const FrustumLanes& lanes, __m256 sx, __m256 sy, __m256 sz, __m256 sr) {
+    const __m256 zero = _mm256_setzero_ps();
+    __m256 inside = _mm256_castsi256_ps(_mm256_set1_epi32(-1));
+    for (int p = 0; p < 6; p++) {
+        __m256 distance = _mm256_add_ps(_mm256_mul_ps(lanes.x[p], sx), _mm256_add_ps(_mm256_mul_ps(lanes.y[p], sy),
+            _mm256_add_ps(_mm256_mul_ps(lanes.z[p], sz), _mm256_add_ps(lanes.w[p], sr))));
+        inside = _mm256_and_ps(inside, _mm256_cmp_ps(distance, zero, _CMP_GE_OQ));
+    }
+    return inside;
+}
+#elif defined(MATH_SIMD_SSE)
+struct FrustumLanes {
+    __m128 x[6], y[6], z[6], w[6];
+};
+
+static inline FrustumLanes loadFrustumLanes(const Frustum& frustum) {
+    FrustumLanes lanes;
+    for (int p = 0; p < 6; p++) {
+        lanes.x[p] = _mm_set1_ps(frustum.planes[p].x);
+        lanes.y[p] = _mm_set1_ps(frustum.planes[p].y);
+        lanes.z[p] = _mm_set1_ps(frustum.planes[p].z);
+        lanes.w[p] = _mm_set1_ps(frustum.planes[p].w);
+    }
+    return lanes;
+}
+
+static inline __m128 insideFrustum(const FrustumLanes& lanes, __m128 sx, __m128 sy, __m128 sz, __m128 sr) {
+    const __m128 zero = _mm_setzero_ps();
+    __m128 inside = _mm_castsi128_ps(_mm_set1_epi32(-1));
+    for (int p = 0; p < 6; p++) {
+        __m128 distance = _mm_add_ps(_mm_mul_ps(lanes.x[p], sx), _mm_add_ps(_mm_mul_ps(lanes.y[p], sy),
+            _mm_add_ps(_mm_mul_ps(lanes.z[p], sz), _mm_add_ps(lanes.w[p], sr))));
+        inside = _mm_and_ps(inside, _mm_cmpge_ps(distance, zero));
+    }
+    return inside;
+}
+#elif defined(MATH_SIMD_NEON)
+static inline uint32x4_t insideFrustum(const Frustum& frustum, float32x4_t sx, float32x4_t sy, float32x4_t sz, float32x4_t sr) {
+    uint32x4_t inside = vdupq_n_u32(0xFFFFFFFF);
+    for (const Vec4& plane : frustum.planes) {
+        float32x4_t distance = vaddq_f32(vdupq_n_f32(plane.w), sr);
+        distance = vfmaq_n_f32(distance, sx, plane.x);
+        distance = vfmaq_n_f32(distance, sy, plane.y);
+        distance = vfmaq_n_f32(distance, sz, plane.z);
+        inside = vandq_u32(inside, vcgezq_f32(distance));
+    }
+    return inside;
+}
+
+static const uint32x4_t NEON_LANE_BITS = { 1, 2, 4, 8 };
+#endif
+
+size_t cullSpheres(const Frustum& frustum, const SphereBounds& bounds, uint32_t* visible) {
+#if defined(MATH_SIMD_AVX)
+    const float *x = bounds.GetX(), *y = bounds.GetY(), *z = bounds.GetZ(), *radius = bounds.GetRadius();
+    size_t visibleCount = 0;
+    FrustumLanes lanes = loadFrustumLanes(frustum);
+    for (size_t i = 0; i < bounds.GetPaddedCount(); i += 8) {
+        __m256 inside = insideFrustum(lanes, _mm256_loadu_ps(x + i), _mm256_loadu_ps(y + i), _mm256_loadu_ps(z + i), _mm256_loadu_ps(radius + i));
+        visibleCount = compactMask((uint32_t)_mm256_movemask_ps(inside), (uint32_t)i, visible, visibleCount);
+    }
+    return visibleCount;
+#elif defined(MATH_SIMD_SSE)
+    const float *x = bounds.GetX(), *y = bounds.GetY(), *z = bounds.GetZ(), *radius = bounds.GetRadius();
+    size_t visibleCount = 0;
+    FrustumLanes lanes = loadFrustumLanes(frustum);
+    for (size_t i = 0; i < bounds.GetPaddedCount(); i += 4) {
+        __m128 inside = insideFrustum(lanes, _mm_loadu_ps(x + i), _mm_loadu_ps(y + i), _mm_loadu_ps(z + i), _mm_loadu_ps(radius + i));
+        visibleCount = compactMask((uint32_t)_mm_movemask_ps(inside), (uint32_t)i, visible, visibleCount);
+    }
+    return visibleCount;
+#elif defined(MATH_SIMD_NEON)
+    const float *x = bounds.GetX(), *y = bounds.GetY(), *z = bounds.GetZ(), *radius = bounds.GetRadius();
+    size_t visibleCount = 0;
+    for (size_t i = 0; i < bounds.GetPaddedCount(); i += 4) {
+        uint32x4_t inside = insideFrustum(frustum, vld1q_f32(x + i), vld1q_f32(y + i), vld1q_f32(z + i), vld1q_f32(radius + i));
+        visibleCount = compactMask(vaddvq_u32(vandq_u32(inside, NEON_LANE_BITS)), (uint32_t)i, visible, visibleCount);
+    }
+    return visibleCount;
+#else
+    return cullSpheresScalar(frustum, bounds, visible);
+#endif
+}
+
+void ClusterBounds::Clear() {
+    m_Spheres.Clear();
+    for (std::vector<float>* cone : { &m_ApexX, &m_ApexY, &m_ApexZ, &m_ConeX, &m_ConeY, &m_ConeZ, &m_ConeCutoffSquared }) cone->clear();
+}
+
+void ClusterBounds::Add(const Vec3& center, float radius, const Vec3& coneApex, const Vec3& coneAxis, float coneCutoff) {
+    size_t i = m_Spheres.GetCount();
+    m_Spheres.Add(center, radius);
+    // axe nul : t = 0, jamais de dos ; le remplissage est de toute facon rejete par le frustum
+    size_t padded = m_Spheres.GetPaddedCount();
+    for (std::vector<float>* cone : { &m_ApexX, &m_ApexY, &m_ApexZ, &m_ConeX, &m_ConeY, &m_ConeZ, &m_ConeCutoffSquared }) cone->resize(padded, 0.0f);
+    m_ApexX[i] = coneApex.x;
+    m_ApexY[i] = coneApex.y;
+    m_ApexZ[i] = coneApex.z;
+    m_ConeX[i] = coneAxis.x;
+    m_ConeY[i] = coneAxis.y;
+    m_ConeZ[i] = coneAxis.z;
+    m_ConeCutoffSquared[i] = coneCutoff * coneCutoff;
+}
+
+size_t cullClustersScalar(const Frustum& frustum, const Vec3& camera, const ClusterBounds& clusters, uint32_t* visible) {
+    const SphereBounds& spheres = clusters.GetSpheres();
+    const float *x = spheres.GetX(), *y = spheres.GetY(), *z = spheres.GetZ(), *radius = spheres.GetRadius();
+    const float *apexX = clusters.GetApexX(), *apexY = clusters.GetApexY(), *apexZ = clusters.GetApexZ();
+    const float *coneX = clusters.GetConeX(), *coneY = clusters.GetConeY(), *coneZ = clusters.GetConeZ();
+    const float* cutoffSquared = clusters.GetConeCutoffSquared();
+    size_t visibleCount = 0;
+    for (size_t i = 0; i < clusters.GetCount(); i++) {
+        bool inside = true;
+        for (const Vec4& plane : frustum.planes) {
+            inside = inside && plane.x * x[i] + (plane.y * y[i] + (plane.z * z[i] + (plane.w + radius[i]))) >= 0.0f;
+        }
+        // meme ordre d'evaluation que les versions SIMD et le compute shader
+        float dx = apexX[i] - camera.x, dy = apexY[i] - camera.y, dz = apexZ[i] - camera.z;
+        float t = coneX[i] * dx + (coneY[i] * dy + coneZ[i] * dz);
+        float distanceSquared = dx * dx + (dy * dy + dz * dz);
+        bool backFacing = t > 0.0f && t * t >= cutoffSquared[i] * distanceSquared;
+        if (inside && !backFacing) visible[visibleCount++] = (uint32_t)i;
+    }
+    return visibleCount;
+}
+
+size_t cullClusters(const Frustum& frustum, const Vec3& camera, const ClusterBounds& clusters, uint32_t* visible) {
+#if defined(MATH_SIMD_AVX)
+    const SphereBounds& spheres = clusters.GetSpheres();
+    const float *x = spheres.GetX(), *y = spheres.GetY(), *z = spheres.GetZ(), *radius = spheres.GetRadius();
+    const float *apexX = clusters.GetApexX(), *apexY = clusters.GetApexY(), *apexZ = clusters.GetApexZ();
+    const float *coneX = clusters.GetConeX(), *coneY = clusters.GetConeY(), *coneZ = clusters.GetConeZ();
+    const float* cutoffSquared = clusters.GetConeCutoffSquared();
+    size_t visibleCount = 0;
+    FrustumLanes lanes = loadFrustumLanes(frustum);
+    const __m256 cameraX = _mm256_set1_ps(camera.x), cameraY = _mm256_set1_ps(camera.y), cameraZ = _mm256_set1_ps(camera.z);
+    const __m256 zero = _mm256_setzero_ps();
+    for (size_t i = 0; i < clusters.GetPaddedCount(); i += 8) {
+        __m256 inside = insideFrustum(lanes, _mm256_loadu_ps(x + i), _mm256_loadu_ps(y + i), _mm256_loadu_ps(z + i), _mm256_loadu_ps(radius + i));
+
+        __m256 dx = _mm256_sub_ps(_mm256_loadu_ps(apexX + i), cameraX);
+        __m256 dy = _mm256_sub_ps(_mm256_loadu_ps(apexY + i), cameraY);
+        __m256 dz = _mm256_sub_ps(_mm256_loadu_ps(apexZ + i), cameraZ);
+        __m256 t = _mm256_add_ps(_mm256_mul_ps(_mm256_loadu_ps(coneX + i), dx),
+            _mm256_add_ps(_mm256_mul_ps(_mm256_loadu_ps(coneY + i), dy), _mm256_mul_ps(_mm256_loadu_ps(coneZ + i), dz)));
+        __m256 distanceSquared = _mm256_add_ps(_mm256_mul_ps(dx, dx), _mm256_add_ps(_mm256_mul_ps(dy, dy), _mm256_mul_ps(dz, dz)));
+        __m256 backFacing = _mm256_and_ps(_mm256_cmp_ps(t, zero, _CMP_GT_OQ),
+            _mm256_cmp_ps(_mm256_mul_ps(t, t), _mm256_mul_ps(_mm256_loadu_ps(cutoffSquared + i), distanceSquared), _CMP_GE_OQ));
+        visibleCount = compactMask((uint32_t)_mm256_movemask_ps(_mm256_andnot_ps(backFacing, inside)), (uint32_t)i, visible, visibleCount);
+    }
+    return visibleCount;
+#elif defined(MATH_SIMD_SSE)
+    const SphereBounds& spheres = clusters.GetSpheres();
+    const float *x = spheres.GetX(), *y = spheres.GetY(), *z = spheres.GetZ(), *radius = spheres.GetRadius();
+    const float *apexX = clusters.GetApexX(), *apexY = clusters.GetApexY(), *apexZ = clusters.GetApexZ();
+    const float *coneX = clusters.GetConeX(), *coneY = clusters.GetConeY(), *coneZ = clusters.GetConeZ();
+    const float* cutoffSquared = clusters.GetConeCutoffSquared();
+    size_t visibleCount = 0;
+    FrustumLanes lanes = loadFrustumLanes(frustum);
+    const __m128 cameraX = _mm_set1_ps(camera.x), cameraY = _mm_set1_ps(camera.y), cameraZ = _mm_set1_ps(camera.z);
+    const __m128 zero = _mm_setzero_ps();
+    for (size_t i = 0; i < clusters.GetPaddedCount(); i += 4) {
+        __m128 inside = insideFrustum(lanes, _mm_loadu_ps(x + i), _mm_loadu_ps(y + i), _mm_loadu_ps(z + i), _mm_loadu_ps(radius + i));
+
+        __m128 dx = _mm_sub_ps(_mm_loadu_ps(apexX + i), cameraX);
+        __m128 dy = _mm_sub_ps(_mm_loadu_ps(apexY + i), cameraY);
+        __m128 dz = _mm_sub_ps(_mm_loadu_ps(apexZ + i), cameraZ);
+        __m128 t = _mm_add_ps(_mm_mul_ps(_mm_loadu_ps(coneX + i), dx),
+            _mm_add_ps(_mm_mul_ps(_mm_loadu_ps(coneY + i), dy), _mm_mul_ps(_mm_loadu_ps(coneZ + i), dz)));
+        __m128 distanceSquared = _mm_add_ps(_mm_mul_ps(dx, dx), _mm_add_ps(_mm_mul_ps(dy, dy), _mm_mul_ps(dz, dz)));
+        __m128 backFacing = _mm_and_ps(_mm_cmpgt_ps(t, zero), _mm_cmpge_ps(_mm_mul_ps(t, t), _mm_mul_ps(_mm_loadu_ps(cutoffSquared + i), distanceSquared)));
+        visibleCount = compactMask((uint32_t)_mm_movemask_ps(_mm_andnot_ps(backFacing, inside)), (uint32_t)i, visible, visibleCount);
+    }
+    return visibleCount;
+#elif defined(MATH_SIMD_NEON)
+    const SphereBounds& spheres = clusters.GetSpheres();
+    const float *x = spheres.GetX(), *y = spheres.GetY(), *z = spheres.GetZ(), *radius = spheres.GetRadius();
+    const float *apexX = clusters.GetApexX(), *apexY = clusters.GetApexY(), *apexZ = clusters.GetApexZ();
+    const float *coneX = clusters.GetConeX(), *coneY = clusters.GetConeY(), *coneZ = clusters.GetConeZ();
+    const float* cutoffSquared = clusters.GetConeCutoffSquared();
+    size_t visibleCount = 0;
+    for (size_t i = 0; i < clusters.GetPaddedCount(); i += 4) {
+        uint32x4_t inside = insideFrustum(frustum, vld1q_f32(x + i), vld1q_f32(y + i), vld1q_f32(z + i), vld1q_f32(radius + i));
+
+        float32x4_t dx = vsubq_f32(vld1q_f32(apexX + i), vdupq_n_f32(camera.x));
+        float32x4_t dy = vsubq_f32(vld1q_f32(apexY + i), vdupq_n_f32(camera.y));
+        float32x4_t dz = vsubq_f32(vld1q_f32(apexZ + i), vdupq_n_f32(camera.z));
+        float32x4_t t = vaddq_f32(vmulq_f32(vld1q_f32(coneX + i), dx), vaddq_f32(vmulq_f32(vld1q_f32(coneY + i), dy), vmulq_f32(vld1q_f32(coneZ + i), dz)));
+        float32x4_t distanceSquared = vaddq_f32(vmulq_f32(dx, dx), vaddq_f32(vmulq_f32(dy, dy), vmulq_f32(dz, dz)));
+        uint32x4_t backFacing = vandq_u32(vcgtzq_f32(t), vcgeq_f32(vmulq_f32(t, t), vmulq_f32(vld1q_f32(cutoffSquared + i), distanceSquared)));
+        visibleCount = compactMask(vaddvq_u32(vandq_u32(vbicq_u32(inside, backFacing), NEON_LANE_BITS)), (uint32_t)i, visible, visibleCount);
+    }
+    return visibleCount;
+#else
+    return cullClustersScalar(frustum, camera, clusters, visible);
+#endif
+}
@@ -0,0 +1,84 @@
+#pragma once
+
+#include "MathUtils.h"
+#include <cstdint>
+#include <cstddef>
+#include <vector>
+
+// plans gauche, droite, bas, haut, proche, lointain : (a, b, c, d) normalises, interieur si a*x + b*y + c*z + d >= 0
+struct Frustum {
+    Vec4 planes[6];
+};
+
+struct BoundingSphere {
+    Vec3 center;
+    float radius;
+};
+
+// plans extraits de viewProjection (Gribb / Hartmann), en coordonnees monde
+Frustum extractFrustum(const Mat4& viewProjection);
+
+// position de la camera dans le repere d'une matrice modelView rigide (rotation + translation)
+Vec3 extractCameraPosition(const Mat4& modelView);
+
+// sphere centree sur l'AABB de vertices (position en tete de chaque vertex, stride en floats)
+BoundingSphere computeBoundingSphere(const float* vertices, size_t vertexCount, size_t stride);
+
+// spheres englobantes en structure de tableaux : une composante par tableau, completes par des
+// spheres toujours rejetees jusqu'a un multiple de 8 pour que la boucle SIMD n'ait pas de reste
+class SphereBounds {
+public:
+    void Clear();
+    void Add(const Vec3& center, float radius);
+
+    size_t GetCount() const { return m_Count; }
+    size_t GetPaddedCount() const { return m_X.size(); }
+
+    const float* GetX() const { return m_X.data(); }
+    const float* GetY() const { return m_Y.data(); }
+    const float* GetZ() const { return m_Z.data(); }
+    const float* GetRadius() const { return m_Radius.data(); }
+
+private:
+    std::vector<float> m_X, m_Y, m_Z, m_Radius;
+    size_t m_Count = 0;
+};
+
+// ecrit dans visible les indices des spheres qui touchent le frustum, dans l'ordre, et renvoie leur nombre
+// visible doit pouvoir contenir GetCount() indices ; 8 spheres par iteration avec AVX, 4 avec SSE / NEON
+size_t cullSpheres(const Frustum& frustum, const SphereBounds& bounds, uint32_t* visible);
+
+// version scalaire de reference
+size_t cullSpheresScalar(const Frustum& frustum, const SphereBounds& bounds, uint32_t* visible);
+
+// clusters d'un mesh : spheres englobantes et cones de normales, en SoA comme SphereBounds
+// un cluster est de dos si t = dot(axe, sommet - camera) > 0 et t^2 >= cutoff^2 * |sommet - camera|^2
+class ClusterBounds {
+public:
+    void Clear();
+    // coneAxis nul : normales sur plus d'un hemisphere, le cluster n'est jamais de dos
+    void Add(const Vec3& center, float radius, const Vec3& coneApex, const Vec3& coneAxis, float coneCutoff);
+
+    size_t GetCount() const { return m_Spheres.GetCount(); }
+    size_t GetPaddedCount() const { return m_Spheres.GetPaddedCount(); }
+    const SphereBounds& GetSpheres() const { return m_Spheres; }
+
+    const float* GetApexX() const { return m_ApexX.data(); }
+    const float* GetApexY() const { return m_ApexY.data(); }
+    const float* GetApexZ() const { return m_ApexZ.data(); }
+    const float* GetConeX() const { return m_ConeX.data(); }
+    const float* GetConeY() const { return m_ConeY.data(); }
+    const float* GetConeZ() const { return m_ConeZ.data(); }
+    const float* GetConeCutoffSquared() const { return m_ConeCutoffSquared.data(); }
+
+private:
+    SphereBounds m_Spheres;
+    std::vector<float> m_ApexX, m_ApexY, m_ApexZ, m_ConeX, m_ConeY, m_ConeZ, m_ConeCutoffSquared;
+};
+
+// indices des clusters qui touchent le frustum et ne sont pas entierement de dos, frustum et camera dans le repere du mesh
+// visible doit pouvoir contenir GetCount() indices ; meme decoupage SIMD que cullSpheres
+size_t cullClusters(const Frustum& frustum, const Vec3& camera, const ClusterBounds& clusters, uint32_t* visible);
+
+// version scalaire de reference
+size_t cullClustersScalar(const Frustum& frustum, const Vec3& camera, const ClusterBounds& clusters, uint32_t* visible);
@@ -0,0 +1,13 @@
+#version 330 core
+layout(location = 0) in vec3 position;
+layout(location = 1) in vec4 color;
+
+out vec4 fragColor;
+
+#include "Camera.glsl"
+
+// lignes de debug deja exprimees dans le repere monde
+void main() {
+    gl_Position = viewProjection * vec4(position, 1.0);
+    fragColor = color;
+}
@@ -0,0 +1,84 @@
+#include "DebugDraw.h"
+#include "UniformBuffer.h"
+#include "GLStateCache.h"
+#include <GL/glew.h>
+#include <GL/gl.h>
+#include <cstring>
+
+DebugDraw::DebugDraw() : m_VAO(0), m_Shader(nullptr) {}
+
+DebugDraw::~DebugDraw() {
+    Destroy();
+}
+
+void DebugDraw::SubmitShaders(ShaderLibrary& library) {
+    m_Shader = library.Request({ SHADER_DEBUG, 0 });
+}
+
+bool DebugDraw::Create(const RingBuffer& ring) {
+    if (!m_Shader || !m_Shader->GetProgram()) return false;
+
+    // les attributs pointent dans le ring, l'offset est redonne a chaque frame
+    glGenVertexArrays(1, &m_VAO);
+    glState.BindVertexArray(m_VAO);
+    glState.BindBuffer(GL_ARRAY_BUFFER, ring.m_Buffer);
+    glVertexAttribPointer(0, 3, GL_FLOAT, GL_FALSE, sizeof(DebugVertex), (void*)0);
+    glEnableVertexAttribArray(0);
+    glVertexAttribPointer(1, 4, GL_UNSIGNED_BYTE, GL_TRUE, sizeof(DebugVertex), (void*)offsetof(DebugVertex, color));
+    glEnableVertexAttribArray(1);
+    glState.BindVertexArray(0);
+    return true;
+}
+
+void DebugDraw::Destroy() {
+    m_Shader = nullptr;
+    if (m_VAO) {
+        glState.ForgetVertexArray(m_VAO);
+        glDeleteVertexArrays(1, &m_VAO);
+        m_VAO = 0;
+    }
+    m_Vertices.clear();
+}
+
+void DebugDraw::AddLine(const Vec3& a, const Vec3& b, uint32_t color) {
+    m_Vertices.push_back({ { a.x, a.y, a.z }, color });
+    m_Vertices.push_back({ { b.x, b.y, b.z }, color });
+}
+
+void DebugDraw::AddBox(const Vec3& min, const Vec3& max, const Mat4& transform, uint32_t color) {
+    // coin i : bit 0 = x, bit 1 = y, bit 2 = z
+    Vec3 corners[8];
+    for (int i = 0; i < 8; i++) {
+        Vec4 corner = { i & 1 ? max.x : min.x, i & 2 ? max.y : min.y, i & 4 ? max.z : min.z, 1.0f };
+        Vec4 world = transformVec4(transform, corner);
+        corners[i] = { world.x, world.y, world.z };
+    }
+    // une arete relie deux coins qui ne different que d'un bit
+    for (int i = 0; i < 8; i++) {
+        for (int bit = 1; bit < 8; bit <<= 1) {
+            if (!(i & bit)) AddLine(corners[i], corners[i | bit], color);
+        }
+    }
+}
+
+void DebugDraw::Submit(RingBuffer& ring, RenderQueue& queue) {
+    if (m_Vertices.empty()) return;
+
+    size_t size = m_Vertices.size() * sizeof(DebugVertex);
+    RingAllocation allocation = ring.Allocate(size, sizeof(DebugVertex));
+    if (!allocation.data) {
+        m_Vertices.clear();
+        return;
+    }
+    memcpy(allocation.data, m_Vertices.data(), size);
+
+    glState.BindVertexArray(m_VAO);
+    glState.BindBuffer(GL_ARRAY_BUFFER, ring.m_Buffer);
+    glVertexAttribPointer(0, 3, GL_FLOAT, GL_FALSE, sizeof(DebugVertex), (void*)allocation.offset);
+    glVertexAttribPointer(1, 4, GL_UNSIGNED_BYTE, GL_TRUE, sizeof(DebugVertex), (void*)(allocation.offset + offsetof(DebugVertex, color)));
+
+    DrawPacket packet = { m_Shader, m_VAO, GL_LINES, (uint32_t)m_Vertices.size(), 0, 0, NO_OBJECT_BLOCK, 0, 0, 0, 0, 0 };
+    queue.Submit(makeSortKey(RENDER_PASS_OVERLAY, m_Shader->GetProgram(), m_VAO, 0.0f), packet);
+
+    m_Vertices.clear();
+}
@@ -0,0 +1,39 @@
+#pragma once
+
+#include "ShaderLibrary.h"
+#include "MathUtils.h"
+#include "RingBuffer.h"
+#include "RenderQueue.h"
+#include <cstdint>
+#include <vector>
+
+// vertex de ligne de debug : position monde + couleur RGBA 8 bits (0xAABBGGRR)
+struct DebugVertex {
+    float position[3];
+    uint32_t color;
+};
+
+// lignes accumulees pendant la frame puis dessinees en un seul draw depuis le ring buffer
+class DebugDraw {
+public:
+    uint32_t m_VAO;
+
+    DebugDraw();
+    ~DebugDraw();
+
+    // le shader est soumis avec les autres, Create est appele une fois la compilation terminee
+    void SubmitShaders(ShaderLibrary& library);
+    bool Create(const RingBuffer& ring);
+    void Destroy();
+
+    void AddLine(const Vec3& a, const Vec3& b, uint32_t color);
+    // boite [min, max] transformee par transform (12 aretes)
+    void AddBox(const Vec3& min, const Vec3& max, const Mat4& transform, uint32_t color);
+
+    // copie les lignes dans le ring, soumet un draw a la passe overlay et vide la liste
+    void Submit(RingBuffer& ring, RenderQueue& queue);
+
+private:
+    GLShader* m_Shader;   // variante possedee par la ShaderLibrary
+    std::vector<DebugVertex> m_Vertices;
+};
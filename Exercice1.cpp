@@ -1,144 +1,536 @@
 #include "GLShader.h" 
+#include "Benchmark.h"
+#include "Mesh.h"
+#include "CubeData.h"
+#include "MathUtils.h"
+#include "UniformBuffer.h"
+#include "Instances.h"
+#include "Culling.h"
+#include "GpuCulling.h"
+#include "GpuProfiler.h"
+#include "OcclusionCulling.h"
+#include "JobSystem.h"
+#include "RingBuffer.h"
+#include "DebugDraw.h"
+#include "ShaderCache.h"
+#include "ShaderLibrary.h"
+#include "FileWatcher.h"
+#include "GLStateCache.h"
+#include "RenderQueue.h"
+#include "SoftwareRasterizer.h"
+#include "PngWriter.h"
+#include "Profiler.h"
+#include <vector>
+#include <algorithm>
 #include <iostream>
 #include <cmath>
+#include <cstring>
+#include <cstdlib>
+#include <climits>
 #include <GL/glew.h>
 #include <GLFW/glfw3.h>
 
 
 GLuint vao, vbo, ebo;
-GLShader shader; 
+Mesh dragon;
 
-// structure pour un vecteur 3D
-struct Vec3 {
-    float x, y, z;
+// scene rendue
+enum Scene {
+    SCENE_CUBE,
+    SCENE_DRAGON,
+    SCENE_INSTANCES    // N cubes ou dragons en un seul draw instancie
 };
 
-// structure pour une matrice 4x4
-struct Mat4 {
-    float data[16];
+// options de la ligne de commande
+struct Options {
+    bool headless = false;     // rendu hors ecran dans un FBO, sans fenetre visible
+    int frames = 0;            // nombre de frames a rendre (0 = infini)
+    bool perFrame = false;     // afficher le detail de chaque frame
+    int width = 800;
+    int height = 600;
+    const char* meshPath = "Dragon.mesh"; // genere par MeshConverter
+    Scene scene = SCENE_CUBE;
+    uint32_t instanceCount = 10000;
+    bool instanceDragon = false;  // instancier le dragon au lieu du cube
+    uint32_t threads = 0;         // threads de mise a jour des instances (0 = tous les coeurs)
+    bool debug = false;           // dessiner les boites englobantes
+    bool gpuCull = false;         // culling des instances par compute shader et draw indirect
+    bool clusterCull = true;      // dragon seul : rejeter les clusters hors champ ou de dos (draw indirect par cluster)
+    bool occlusionCull = false;   // instances, culling CPU : rejeter celles cachees par les plus proches
+    float lodError = 1.0f;        // erreur geometrique toleree a l'ecran, en pixels, pour choisir le LOD (0 : toujours le niveau 0)
+    bool shaderCache = true;      // reutiliser les binaires de programmes d'un lancement precedent
+    ShaderCompileMode shaderCompile = SHADER_COMPILE_PARALLEL;   // repli sur un contexte partage
+    bool blinnPhong = false;      // eclairage du mesh avec speculaire
+    bool precompileShaders = false;   // compiler toutes les variantes dans le cache puis quitter
+    int watch = -1;               // rechargement a chaud (-1 : seulement avec une fenetre)
+    const char* bench = nullptr;  // micro-benchmark a lancer a la place du rendu
+    bool softwareRenderer = false;    // dragon (niveau 0) rasterise sur le CPU, sans contexte GL
+    const char* dumpPath = nullptr;   // derniere frame enregistree en PNG
+    bool gpuProfile = false;      // temps GPU par passe (timer queries), dans le rapport de benchmark
+    bool gpuStatistics = false;   // en plus : vertex, primitives et fragments par passe
+    const char* tracePath = nullptr;  // zones CPU de toute l'execution au format Chrome trace
 };
 
-// fonction pour creer une matrice identite
-Mat4 identityMatrix() {
-    Mat4 mat = {
-        1, 0, 0, 0,
-        0, 1, 0, 0,
-        0, 0, 1, 0,
-        0, 0, 0, 1
-    };
-    return mat;
-}
-
-// fonction pour creer une matrice de translation
-Mat4 translate(float x, float y, float z) {
-    Mat4 mat = identityMatrix();
-    mat.data[12] = x;
-    mat.data[13] = y;
-    mat.data[14] = z;
-    return mat;
-}
-
-// fonction pour creer une matrice de projection en perspective
-Mat4 perspective(float fov, float aspect, float near, float far) {
-    Mat4 mat = { 0 };
-    float tanHalfFOV = tan(fov / 2.0f);
-    mat.data[0] = 1.0f / (aspect * tanHalfFOV);
-    mat.data[5] = 1.0f / tanHalfFOV;
-    mat.data[10] = -(far + near) / (far - near);
-    mat.data[11] = -1.0f;
-    mat.data[14] = -(2.0f * far * near) / (far - near);
-    return mat;
-}
-
-// fonction pour multiplier deux matrices 4x4
-Mat4 multiplyMat4(Mat4 a, Mat4 b) {
-    Mat4 result = { 0 };
-    for (int i = 0; i < 4; i++) {
-        for (int j = 0; j < 4; j++) {
-            result.data[i * 4 + j] =
-                a.data[i * 4 + 0] * b.data[0 * 4 + j] +
-                a.data[i * 4 + 1] * b.data[1 * 4 + j] +
-                a.data[i * 4 + 2] * b.data[2 * 4 + j] +
-                a.data[i * 4 + 3] * b.data[3 * 4 + j];
+Options options;
+GLuint fbo, fboColor, fboDepth;
+
+// locations des uniforms hors blocs, resolues une seule fois apres le chargement du programme
+struct ShaderUniforms {
+    GLint meshCenter = -1;
+    GLint meshExtent = -1;
+};
+
+ShaderUniforms uniforms;
+
+// camera (bloc std140 lie une fois par frame) : view et projection ne changent qu'a
+// l'initialisation et au redimensionnement
+CameraBlock camera;
+float lodPixelsPerUnit;   // pixels couverts par une unite a distance 1, pour projeter l'erreur des LOD
+
+// toutes les donnees qui changent chaque frame (blocs uniformes, matrices d'instances,
+// lignes de debug) sont suballouees dans ce ring triple buffer
+RingBuffer frameRing;
+const size_t FRAME_RING_UNIFORM_SIZE = 64 * 1024;
+size_t uniformAlignment;
+
+// variante de programme specialisee pour la scene courante
+ShaderLibrary shaderLibrary;
+Material sceneMaterial;
+const GLShader* sceneShader;
+DebugDraw debugDraw;
+RenderQueue renderQueue;
+FileWatcher fileWatcher;
+float dragonCenter[3];
+float dragonExtent[3];
+float dragonRadius;
+
+// scene instanciee : une matrice model par instance dans un attribut a diviseur 1
+InstanceSet instances;
+Mat4 instanceBaseModel;
+
+// spheres englobantes des instances (SoA) et indices des visibles apres le culling
+SphereBounds instanceBounds;
+std::vector<uint32_t> visibleInstances;
+float instanceRadius;
+
+// instances de dragon regroupees par LOD : un draw par niveau, decale dans les matrices par baseInstance
+bool instanceLods = false;
+std::vector<uint32_t> lodInstances;
+std::vector<uint32_t> lodLevels;
+std::vector<uint32_t> lodFirst;   // rang du premier visible de chaque niveau, plus la fin
+
+// variante GPU : compaction par compute shader, le resultat n'est compare au CPU qu'a la premiere frame
+GpuCuller gpuCuller;
+bool gpuCullVerified = false;
+size_t instanceAlignment = sizeof(Mat4);   // les matrices lues comme SSBO suivent aussi son alignement
+
+// clusters du niveau 0 du dragon : bornes SoA et indices des visibles, ou commandes ecrites par le GPU
+bool clusterCulling = false;
+ClusterBounds dragonClusters;
+std::vector<uint32_t> visibleClusters;
+GpuClusterCuller gpuClusterCuller;
+bool gpuClusterCullVerified = false;
+
+// occlusion culling des instances : les plus proches dans le champ servent d'occulteurs (cube ou LOD le plus grossier du dragon)
+bool occlusionCulling = false;
+OcclusionBuffer occlusionBuffer;
+std::vector<std::pair<float, uint32_t>> occluderCandidates;
+std::vector<uint32_t> occluderIndices;
+std::vector<Mat4> occluderModels;
+
+// mise a jour des matrices model repartie sur les coeurs
+JobSystem jobSystem;
+const size_t INSTANCE_JOB_GRAIN = 512;
+
+// au-dela, les matrices des instances ne tiennent plus raisonnablement dans le ring buffer (64 Mo par region)
+const uint32_t MAX_INSTANCES = 1000000;
+const int MAX_THREADS = 256;
+const int MAX_SIZE = 16384;   // GL_MAX_RENDERBUFFER_SIZE courant
+
+void printUsage(const char* program) {
+    std::cerr << "Usage : " << program << " [--headless] [--frames N] [--per-frame] [--scene cube|dragon|instances] [--instances N] [--instance-mesh cube|dragon] [--threads N] [--cull cpu|gpu] [--lod-error PX] [--debug] [--no-shader-cache] [--shader-compile sync|parallel|worker] [--lighting lambert|blinn-phong] [--watch|--no-watch] [--precompile-shaders] [--mesh fichier.mesh] [--size W H] [--no-cluster-cull] [--occlusion-cull] [--renderer gl|software] [--dump image.png] [--gpu-profile time|stats] [--trace trace.json] [--bench math|jobs|queue|cull|clusters]" << std::endl;
+}
+
+// entier decimal dans [minimum, maximum], sinon message et usage
+bool parseInteger(const char* program, const char* what, const char* text, int minimum, int maximum, int& value) {
+    char* end = nullptr;
+    long parsed = strtol(text, &end, 10);
+    if (end == text || *end != '\0' || parsed < minimum || parsed > maximum) {
+        std::cerr << what << " invalide : " << text << " (" << minimum << " a " << maximum << ")" << std::endl;
+        printUsage(program);
+        return false;
+    }
+    value = (int)parsed;
+    return true;
+}
+
+bool parseOptions(int argc, char** argv) {
+    for (int i = 1; i < argc; i++) {
+        if (strcmp(argv[i], "--headless") == 0) {
+            options.headless = true;
+        } else if (strcmp(argv[i], "--frames") == 0 && i + 1 < argc) {
+            if (!parseInteger(argv[0], "Nombre de frames", argv[++i], 0, INT_MAX, options.frames)) return false;
+        } else if (strcmp(argv[i], "--per-frame") == 0) {
+            options.perFrame = true;
+        } else if (strcmp(argv[i], "--scene") == 0 && i + 1 < argc) {
+            i++;
+            if (strcmp(argv[i], "cube") == 0) options.scene = SCENE_CUBE;
+            else if (strcmp(argv[i], "dragon") == 0) options.scene = SCENE_DRAGON;
+            else if (strcmp(argv[i], "instances") == 0) options.scene = SCENE_INSTANCES;
+            else {
+                std::cerr << "Scene inconnue : " << argv[i] << std::endl;
+                return false;
+            }
+        } else if (strcmp(argv[i], "--instances") == 0 && i + 1 < argc) {
+            options.scene = SCENE_INSTANCES;
+            int count = 0;
+            if (!parseInteger(argv[0], "Nombre d'instances", argv[++i], 1, (int)MAX_INSTANCES, count)) return false;
+            options.instanceCount = (uint32_t)count;
+        } else if (strcmp(argv[i], "--instance-mesh") == 0 && i + 1 < argc) {
+            i++;
+            if (strcmp(argv[i], "cube") == 0) options.instanceDragon = false;
+            else if (strcmp(argv[i], "dragon") == 0) options.instanceDragon = true;
+            else {
+                std::cerr << "Mesh d'instance inconnu : " << argv[i] << std::endl;
+                printUsage(argv[0]);
+                return false;
+            }
+        } else if (strcmp(argv[i], "--threads") == 0 && i + 1 < argc) {
+            // 0 : tous les coeurs
+            int threads = 0;
+            if (!parseInteger(argv[0], "Nombre de threads", argv[++i], 0, MAX_THREADS, threads)) return false;
+            options.threads = (uint32_t)threads;
+        } else if (strcmp(argv[i], "--debug") == 0) {
+            options.debug = true;
+        } else if (strcmp(argv[i], "--cull") == 0 && i + 1 < argc) {
+            i++;
+            if (strcmp(argv[i], "cpu") == 0) options.gpuCull = false;
+            else if (strcmp(argv[i], "gpu") == 0) options.gpuCull = true;
+            else {
+                std::cerr << "Mode de culling inconnu : " << argv[i] << std::endl;
+                printUsage(argv[0]);
+                return false;
+            }
+        } else if (strcmp(argv[i], "--no-cluster-cull") == 0) {
+            options.clusterCull = false;
+        } else if (strcmp(argv[i], "--occlusion-cull") == 0) {
+            options.occlusionCull = true;
+        } else if (strcmp(argv[i], "--lod-error") == 0 && i + 1 < argc) {
+            options.lodError = (float)atof(argv[++i]);
+        } else if (strcmp(argv[i], "--no-shader-cache") == 0) {
+            options.shaderCache = false;
+        } else if (strcmp(argv[i], "--watch") == 0) {
+            options.watch = 1;
+        } else if (strcmp(argv[i], "--no-watch") == 0) {
+            options.watch = 0;
+        } else if (strcmp(argv[i], "--lighting") == 0 && i + 1 < argc) {
+            i++;
+            if (strcmp(argv[i], "lambert") == 0) options.blinnPhong = false;
+            else if (strcmp(argv[i], "blinn-phong") == 0) options.blinnPhong = true;
+            else {
+                std::cerr << "Eclairage inconnu : " << argv[i] << std::endl;
+                printUsage(argv[0]);
+                return false;
+            }
+        } else if (strcmp(argv[i], "--precompile-shaders") == 0) {
+            options.precompileShaders = true;
+            options.headless = true;
+        } else if (strcmp(argv[i], "--shader-compile") == 0 && i + 1 < argc) {
+            i++;
+            if (strcmp(argv[i], "sync") == 0) options.shaderCompile = SHADER_COMPILE_SYNC;
+            else if (strcmp(argv[i], "parallel") == 0) options.shaderCompile = SHADER_COMPILE_PARALLEL;
+            else if (strcmp(argv[i], "worker") == 0) options.shaderCompile = SHADER_COMPILE_WORKER;
+            else {
+                std::cerr << "Mode de compilation inconnu : " << argv[i] << std::endl;
+                printUsage(argv[0]);
+                return false;
+            }
+        } else if (strcmp(argv[i], "--bench") == 0 && i + 1 < argc) {
+            options.bench = argv[++i];
+        } else if (strcmp(argv[i], "--mesh") == 0 && i + 1 < argc) {
+            options.meshPath = argv[++i];
+        } else if (strcmp(argv[i], "--renderer") == 0 && i + 1 < argc) {
+            i++;
+            if (strcmp(argv[i], "gl") == 0) options.softwareRenderer = false;
+            else if (strcmp(argv[i], "software") == 0) options.softwareRenderer = true;
+            else {
+                std::cerr << "Moteur de rendu inconnu : " << argv[i] << std::endl;
+                printUsage(argv[0]);
+                return false;
+            }
+            if (options.softwareRenderer) options.headless = true;
+        } else if (strcmp(argv[i], "--dump") == 0 && i + 1 < argc) {
+            options.dumpPath = argv[++i];
+        } else if (strcmp(argv[i], "--trace") == 0 && i + 1 < argc) {
+            options.tracePath = argv[++i];
+        } else if (strcmp(argv[i], "--gpu-profile") == 0 && i + 1 < argc) {
+            i++;
+            if (strcmp(argv[i], "time") == 0) options.gpuStatistics = false;
+            else if (strcmp(argv[i], "stats") == 0) options.gpuStatistics = true;
+            else {
+                std::cerr << "Mode de profilage GPU inconnu : " << argv[i] << std::endl;
+                printUsage(argv[0]);
+                return false;
+            }
+            options.gpuProfile = true;
+        } else if (strcmp(argv[i], "--size") == 0 && i + 2 < argc) {
+            if (!parseInteger(argv[0], "Largeur", argv[++i], 1, MAX_SIZE, options.width)) return false;
+            if (!parseInteger(argv[0], "Hauteur", argv[++i], 1, MAX_SIZE, options.height)) return false;
+        } else {
+            std::cerr << "Option inconnue : " << argv[i] << std::endl;
+            printUsage(argv[0]);
+            return false;
         }
     }
-    return result;
-}
-
-// fonctions pour creer des matrices de rotation autour des axes Y, X et Z 
-Mat4 rotateY(float angle) {
-    Mat4 mat = identityMatrix();
-    mat.data[0] = cos(angle);
-    mat.data[2] = sin(angle);
-    mat.data[8] = -sin(angle);
-    mat.data[10] = cos(angle);
-    return mat;
-}
-
-Mat4 rotateX(float angle) {
-    Mat4 mat = identityMatrix();
-    mat.data[5] = cos(angle);
-    mat.data[6] = -sin(angle);
-    mat.data[9] = sin(angle);
-    mat.data[10] = cos(angle);
-    return mat;
-}
-
-Mat4 rotateZ(float angle) {
-    Mat4 mat = identityMatrix();
-    mat.data[0] = cos(angle);
-    mat.data[1] = -sin(angle);
-    mat.data[4] = sin(angle);
-    mat.data[5] = cos(angle);
-    return mat;
-}
-
-float cube_vertices[] = {
-    -1.0f, -1.0f,  1.0f,   1.0f, 0.0f, 0.0f,
-     1.0f, -1.0f,  1.0f,   0.0f, 1.0f, 0.0f,
-     1.0f,  1.0f,  1.0f,   0.0f, 0.0f, 1.0f,
-    -1.0f,  1.0f,  1.0f,   1.0f, 1.0f, 0.0f,
-    -1.0f, -1.0f, -1.0f,   1.0f, 0.0f, 1.0f,
-     1.0f, -1.0f, -1.0f,   0.0f, 1.0f, 1.0f,
-     1.0f,  1.0f, -1.0f,   0.5f, 0.5f, 0.5f,
-    -1.0f,  1.0f, -1.0f,   1.0f, 0.5f, 0.5f
-};
+    // en mode headless on ne tourne jamais a l'infini
+    if (options.headless && options.frames <= 0) options.frames = 1000;
+    if (options.watch < 0) options.watch = !options.headless;
+    return true;
+}
 
-unsigned int cube_elements[] = {
-    0, 1, 2, 2, 3, 0,
-    1, 5, 6, 6, 2, 1,
-    7, 6, 5, 5, 4, 7,
-    4, 0, 3, 3, 7, 4,
-    4, 5, 1, 1, 0, 4,
-    3, 2, 6, 6, 7, 3
-};
+// cree la fenetre et le contexte GL (fenetre cachee sans serveur graphique en mode headless)
+GLFWwindow* createContext() {
+#if defined(__linux__) && GLFW_VERSION_MAJOR == 3 && GLFW_VERSION_MINOR >= 4
+    // sur les machines sans GPU ni serveur X : plateforme nulle + contexte OSMesa logiciel
+    if (options.headless) glfwInitHint(GLFW_PLATFORM, GLFW_PLATFORM_NULL);
+#endif
+    if (!glfwInit()) return nullptr;
 
-bool initialize() {
-    if (!glfwInit()) return false;
+    if (options.headless) {
+        glfwWindowHint(GLFW_VISIBLE, GLFW_FALSE);
+#if defined(__linux__) && GLFW_VERSION_MAJOR == 3 && GLFW_VERSION_MINOR >= 4
+        glfwWindowHint(GLFW_CONTEXT_CREATION_API, GLFW_OSMESA_CONTEXT_API);
+#endif
+    }
 
-    GLFWwindow* window = glfwCreateWindow(800, 600, "Cube en rotation", NULL, NULL);
+    GLFWwindow* window = glfwCreateWindow(options.width, options.height, "Cube en rotation", NULL, NULL);
     if (!window) {
         glfwTerminate();
-        return false;
+        return nullptr;
     }
     glfwMakeContextCurrent(window);
+    // pas de vsync pour ne pas fausser les mesures
+    glfwSwapInterval(options.frames > 0 ? 0 : 1);
+    return window;
+}
+
+// cible de rendu hors ecran (couleur + profondeur) utilisee en mode headless
+bool createOffscreenTarget() {
+    glGenFramebuffers(1, &fbo);
+    glGenRenderbuffers(1, &fboColor);
+    glGenRenderbuffers(1, &fboDepth);
+
+    glBindRenderbuffer(GL_RENDERBUFFER, fboColor);
+    glRenderbufferStorage(GL_RENDERBUFFER, GL_RGBA8, options.width, options.height);
+    glBindRenderbuffer(GL_RENDERBUFFER, fboDepth);
+    glRenderbufferStorage(GL_RENDERBUFFER, GL_DEPTH_COMPONENT24, options.width, options.height);
+
+    glBindFramebuffer(GL_FRAMEBUFFER, fbo);
+    glFramebufferRenderbuffer(GL_FRAMEBUFFER, GL_COLOR_ATTACHMENT0, GL_RENDERBUFFER, fboColor);
+    glFramebufferRenderbuffer(GL_FRAMEBUFFER, GL_DEPTH_ATTACHMENT, GL_RENDERBUFFER, fboDepth);
+
+    if (glCheckFramebufferStatus(GL_FRAMEBUFFER) != GL_FRAMEBUFFER_COMPLETE) {
+        std::cerr << "FBO hors ecran incomplet" << std::endl;
+        return false;
+    }
+    glViewport(0, 0, options.width, options.height);
+    return true;
+}
+
+// recalcule view et projection pour la scene et la taille courantes
+void updateCamera() {
+    float fov = 45.0f * (3.14159f / 180.0f);
+    float aspect = (float)options.width / options.height;
+
+    if (options.scene == SCENE_DRAGON || options.scene == SCENE_INSTANCES) {
+        // recule la camera pour que la sphere englobante tienne dans le champ de vision
+        float radius = options.scene == SCENE_DRAGON ? dragonRadius : instances.GetRadius();
+        float distance = radius / sin(fov / 2.0f);
+        camera.view = translate(0.0f, 0.0f, -distance);
+        camera.projection = perspective(fov, aspect, 0.1f, distance + 2.0f * radius);
+    } else {
+        camera.view = translate(0.0f, 0.0f, -5.0f);
+        camera.projection = perspective(fov, aspect, 0.1f, 100.0f);
+    }
+    camera.viewProjection = multiplyMat4(camera.view, camera.projection);
+    lodPixelsPerUnit = options.height / (2.0f * tan(fov / 2.0f));
+}
+
+void framebufferSizeCallback(GLFWwindow*, int width, int height) {
+    if (width <= 0 || height <= 0) return; // fenetre minimisee
+    options.width = width;
+    options.height = height;
+    glViewport(0, 0, width, height);
+    updateCamera();
+    if (occlusionCulling) occlusionBuffer.Create(width, height);
+}
+
+// occulteur commun a toutes les instances : le cube lui-meme, ou le LOD le plus grossier du dragon relu
+// dans le fichier (seuls ses vertex sont gardes)
+bool setupOccluderMesh() {
+    std::vector<Vec3> positions;
+    std::vector<uint32_t> indices;
+    if (options.instanceDragon) {
+        MeshFile mesh;
+        if (!mesh.Open(options.meshPath)) return false;
+        const MeshFileHeader& header = mesh.GetHeader();
+        const MeshLod* lods = mesh.GetLods();
+        uint32_t firstIndex = lods ? lods[header.lodCount - 1].indexOffset : 0;
+        uint32_t indexCount = lods ? lods[header.lodCount - 1].indexCount : header.indexCount;
+        std::vector<uint32_t> remap(header.vertexCount, UINT32_MAX);
+        for (uint32_t i = firstIndex; i < firstIndex + indexCount; i++) {
+            uint32_t vertex = header.indexSize == 2 ? static_cast<const uint16_t*>(mesh.GetIndices())[i] : static_cast<const uint32_t*>(mesh.GetIndices())[i];
+            if (remap[vertex] == UINT32_MAX) {
+                remap[vertex] = (uint32_t)positions.size();
+                float position[3];
+                mesh.DecodePosition(vertex, position);
+                positions.push_back({ position[0], position[1], position[2] });
+            }
+            indices.push_back(remap[vertex]);
+        }
+    } else {
+        for (int vertex = 0; vertex < 8; vertex++) positions.push_back({ cube_vertices[vertex * 6], cube_vertices[vertex * 6 + 1], cube_vertices[vertex * 6 + 2] });
+        indices.assign(cube_elements, cube_elements + 36);
+    }
+    occlusionBuffer.SetOccluderMesh(positions.data(), positions.size(), indices.data(), indices.size());
+    return true;
+}
+
+// matrice de base et attributs d'instance sur le VAO du mesh instancie (refait si le dragon est recharge)
+void setupInstanceMesh() {
+    // le dragon est centre et ramene a la taille du cube
+    instanceBaseModel = options.instanceDragon ?
+        multiplyMat4(translate(-dragonCenter[0], -dragonCenter[1], -dragonCenter[2]), scale(1.5f / dragonRadius, 1.5f / dragonRadius, 1.5f / dragonRadius)) :
+        identityMatrix();
+
+    // le dragon ramene a 1.5 de rayon, le cube d'apres ses vertex ; la rotation se fait autour du centre
+    instanceRadius = options.instanceDragon ? 1.5f : computeBoundingSphere(cube_vertices, 8, 6).radius;
+    instances.GetBounds(instanceRadius, instanceBounds);
+    visibleInstances.resize(instances.GetCount());
+
+    // les LOD passent par baseInstance ; la compaction GPU ecrit une seule commande, au niveau 0
+    instanceLods = options.instanceDragon && !options.gpuCull && options.lodError > 0.0f && dragon.GetLodCount() > 1 &&
+        (GLEW_VERSION_4_2 || GLEW_ARB_base_instance);
+    if (instanceLods) {
+        lodInstances.resize(instances.GetCount());
+        lodLevels.resize(instances.GetCount());
+    }
 
-    if (glewInit() != GLEW_OK) {
+    uint32_t indexCount = options.instanceDragon ? dragon.GetIndexCount() : 36;
+    if (options.gpuCull && !gpuCuller.Create(instanceBounds, indexCount)) {
+        std::cout << "Programme de culling indisponible, culling sur CPU" << std::endl;
+        options.gpuCull = false;
+    }
+
+    // le culling GPU garde sa propre compaction, sans occlusion
+    occlusionCulling = options.occlusionCull && !options.gpuCull;
+    if (occlusionCulling && !setupOccluderMesh()) {
+        std::cout << "Occulteur indisponible, pas d'occlusion culling" << std::endl;
+        occlusionCulling = false;
+    }
+    if (occlusionCulling) occlusionBuffer.Create(options.width, options.height);
+
+    // les matrices sont lues dans le ring (offset redonne a chaque frame) ou dans la liste compactee par le GPU
+    glState.BindVertexArray(options.instanceDragon ? dragon.m_VAO : vao);
+    glState.BindBuffer(GL_ARRAY_BUFFER, options.gpuCull ? gpuCuller.m_VisibleModels : frameRing.m_Buffer);
+
+    // une mat4 occupe 4 locations (3 a 6), une colonne par location
+    for (int column = 0; column < 4; column++) {
+        glVertexAttribPointer(3 + column, 4, GL_FLOAT, GL_FALSE, sizeof(Mat4), (void*)(column * 4 * sizeof(float)));
+        glEnableVertexAttribArray(3 + column);
+        glVertexAttribDivisor(3 + column, 1);
+    }
+    glState.BindVertexArray(0);
+}
+
+// grille d'instances et buffer des matrices model
+void initializeInstances() {
+    PROFILE_FUNCTION();
+    const float spacing = 4.0f;
+    instances.Generate(options.instanceCount, spacing);
+    setupInstanceMesh();
+
+    jobSystem.Initialize(options.threads);
+    std::cout << instances.GetCount() << " instances, " << jobSystem.GetThreadCount() << " threads" << std::endl;
+}
+
+// fenetre, contexte et points d'entree GL
+bool initializeContext() {
+    PROFILE_FUNCTION();
+    if (!createContext()) return false;
+
+    glewExperimental = GL_TRUE;
+    GLenum glewStatus = glewInit();
+    // sans serveur X glewInit signale l'absence de display GLX alors que les fonctions GL sont chargees
+    if (glewStatus != GLEW_OK && !(options.headless && glewStatus == GLEW_ERROR_NO_GLX_DISPLAY)) {
         std::cerr << "Erreur d'initialisation de GLEW" << std::endl;
         return false;
     }
+    return true;
+}
 
-    glEnable(GL_DEPTH_TEST);  
+// centre, demi-etendue et sphere englobante du dragon, recalcules quand le mesh est recharge
+void updateDragonBounds(const MeshFileHeader& header) {
+    dragonRadius = 0.0f;
+    for (int axis = 0; axis < 3; axis++) {
+        dragonCenter[axis] = 0.5f * (header.boundsMin[axis] + header.boundsMax[axis]);
+        dragonExtent[axis] = 0.5f * (header.boundsMax[axis] - header.boundsMin[axis]);
+        dragonRadius += dragonExtent[axis] * dragonExtent[axis];
+    }
+    dragonRadius = sqrt(dragonRadius);
+}
+
+// bornes des clusters du dragon (refait si le dragon est recharge)
+void setupDragonClusters() {
+    dragonClusters.Clear();
+    const MeshCluster* clusters = dragon.GetClusters();
+    for (uint32_t i = 0; i < dragon.GetClusterCount(); i++) {
+        const MeshCluster& cluster = clusters[i];
+        dragonClusters.Add({ cluster.center[0], cluster.center[1], cluster.center[2] }, cluster.radius,
+            { cluster.coneApex[0], cluster.coneApex[1], cluster.coneApex[2] }, { cluster.coneAxis[0], cluster.coneAxis[1], cluster.coneAxis[2] }, cluster.coneCutoff);
+    }
+    visibleClusters.resize(dragonClusters.GetCount());
+
+    // sans clusters (fichier de version < 3) ou sans draw indirect multiple, le niveau 0 est dessine d'un bloc
+    clusterCulling = options.clusterCull && dragon.GetClusterCount() > 0 && GLEW_ARB_multi_draw_indirect;
+    if (clusterCulling && options.gpuCull && !gpuClusterCuller.Create(dragonClusters, clusters)) {
+        std::cout << "Programme de culling indisponible, culling sur CPU" << std::endl;
+        options.gpuCull = false;
+    }
+    gpuClusterCullVerified = false;
+}
+
+// uniforms hors blocs du programme de la scene : a refaire quand le programme ou le mesh change
+void setupSceneShader() {
+    sceneShader->Use();
+    uniforms.meshCenter = sceneShader->GetUniformLocation("meshCenter");
+    uniforms.meshExtent = sceneShader->GetUniformLocation("meshExtent");
+
+    if (uniforms.meshCenter >= 0) {
+        // les positions compressees sont relatives au centre et a la demi-etendue de l'AABB
+        glUniform3fv(uniforms.meshCenter, 1, dragonCenter);
+        glUniform3fv(uniforms.meshExtent, 1, dragonExtent);
+    }
+}
+
+bool initialize() {
+    PROFILE_FUNCTION();
+    if (!initializeContext()) return false;
+
+    if (options.headless && !createOffscreenTarget()) return false;
+    if (!options.headless) glfwSetFramebufferSizeCallback(glfwGetCurrentContext(), framebufferSizeCallback);
+
+    glState.Enable(GL_DEPTH_TEST);  
 
     // Init du cube
     glGenVertexArrays(1, &vao);
     glGenBuffers(1, &vbo);
     glGenBuffers(1, &ebo);
 
-    glBindVertexArray(vao);
-    glBindBuffer(GL_ARRAY_BUFFER, vbo);
+    glState.BindVertexArray(vao);
+    glState.BindBuffer(GL_ARRAY_BUFFER, vbo);
     glBufferData(GL_ARRAY_BUFFER, sizeof(cube_vertices), cube_vertices, GL_STATIC_DRAW);
-    glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, ebo);
+    glState.BindBuffer(GL_ELEMENT_ARRAY_BUFFER, ebo);
     glBufferData(GL_ELEMENT_ARRAY_BUFFER, sizeof(cube_elements), cube_elements, GL_STATIC_DRAW);
 
     glVertexAttribPointer(0, 3, GL_FLOAT, GL_FALSE, 6 * sizeof(float), (void*)0);
@@ -147,63 +539,637 @@ bool initialize() {
     glVertexAttribPointer(1, 3, GL_FLOAT, GL_FALSE, 6 * sizeof(float), (void*)(3 * sizeof(float)));
     glEnableVertexAttribArray(1);
 
-    // charger les shaders
-    if (!shader.LoadShaders("Basic.vs", "Basic.fs")) {
+    // les shaders qui ne dependent pas du mesh sont soumis d'abord et compilent
+    // pendant le chargement du dragon (depuis le cache de binaires si possible)
+    shaderCache.SetEnabled(options.shaderCache);
+    shaderLibrary.Initialize(glfwGetCurrentContext(), options.shaderCompile);
+    double shaderStart = glfwGetTime();
+    bool meshScene = options.scene == SCENE_DRAGON || (options.scene == SCENE_INSTANCES && options.instanceDragon);
+    uint32_t instanced = options.scene == SCENE_INSTANCES ? SHADER_FEATURE_INSTANCED : 0;
+    if (!meshScene) {
+        sceneMaterial = { SHADER_BASIC, instanced };
+        sceneShader = shaderLibrary.Request(sceneMaterial);
+    }
+    if (options.debug) debugDraw.SubmitShaders(shaderLibrary);
+    if (options.gpuCull && (options.scene == SCENE_INSTANCES || options.scene == SCENE_DRAGON)) {
+        if (GpuCuller::IsSupported()) {
+            if (options.scene == SCENE_INSTANCES) gpuCuller.SubmitShaders(shaderLibrary);
+            else gpuClusterCuller.SubmitShaders(shaderLibrary);
+        } else {
+            std::cout << "Compute shaders ou draw indirect absents, culling sur CPU" << std::endl;
+            options.gpuCull = false;
+        }
+    }
+
+    // charger le dragon (fichier mappe en memoire, envoye directement au GPU)
+    double loadStart = glfwGetTime();
+    {
+        PROFILE_SCOPE("load mesh");
+        if (!dragon.Load(options.meshPath)) {
+            return false;
+        }
+    }
+    std::cout << "Mesh " << options.meshPath << " charge en " << (glfwGetTime() - loadStart) * 1000.0 << " ms" << std::endl;
+
+    // variante du shader de mesh, qui depend du format des vertex
+    if (meshScene) {
+        uint32_t quantized = dragon.IsQuantized() ? SHADER_FEATURE_QUANTIZED : 0;
+        uint32_t lighting = options.blinnPhong ? SHADER_FEATURE_BLINN_PHONG : 0;
+        sceneMaterial = { SHADER_MESH, instanced | quantized | lighting };
+        sceneShader = shaderLibrary.Request(sceneMaterial);
+    }
+
+    size_t pending = shaderLibrary.GetPendingCount();
+    double waitStart = glfwGetTime();
+    {
+        PROFILE_SCOPE("wait shaders");
+        if (!shaderLibrary.WaitAll()) {
+            return false;
+        }
+    }
+    double waitMs = (glfwGetTime() - waitStart) * 1000.0;
+    std::cout << "Shaders charges en " << (glfwGetTime() - shaderStart) * 1000.0 << " ms (" << shaderLibrary.GetCompileModeName()
+        << ", " << pending << " encore en compilation apres le mesh, attente " << waitMs << " ms ; cache : "
+        << shaderCache.GetHits() << " binaires reutilises, " << shaderCache.GetMisses() << " compiles)" << std::endl;
+    std::cout << "Variante de la scene : " << ShaderLibrary::GetVariantName(sceneMaterial) << std::endl;
+
+    shaderLibrary.BindUniformBlock("Camera", CAMERA_BLOCK_BINDING);
+    shaderLibrary.BindUniformBlock("Object", OBJECT_BLOCK_BINDING);
+
+    // ring dimensionne pour les blocs uniformes, les lignes de debug et les matrices d'instances
+    uniformAlignment = getUniformOffsetAlignment();
+    if (options.gpuCull) instanceAlignment = std::max(instanceAlignment, GpuCuller::GetStorageOffsetAlignment());
+    size_t instanceBytes = options.scene == SCENE_INSTANCES ? options.instanceCount * sizeof(Mat4) + instanceAlignment : 0;
+    size_t clusterBytes = options.scene == SCENE_DRAGON ? dragon.GetClusterCount() * sizeof(DrawElementsIndirectCommand) : 0;
+    if (!frameRing.Create(FRAME_RING_UNIFORM_SIZE + instanceBytes + clusterBytes)) {
+        return false;
+    }
+    std::cout << "ring buffer : 3 x " << frameRing.GetFrameSize() / 1024 << " Ko, "
+        << (frameRing.IsPersistent() ? "mapping persistant" : "glBufferSubData") << std::endl;
+    if (options.debug && !debugDraw.Create(frameRing)) {
         return false;
     }
-    shader.Use();
+    if (options.gpuProfile) {
+        if (!gpuProfiler.Create(options.gpuStatistics)) {
+            std::cout << "Timer queries absentes, pas de profil GPU" << std::endl;
+        } else if (options.gpuStatistics && !gpuProfiler.IsCollectingStatistics()) {
+            std::cout << "ARB_pipeline_statistics_query absent, profil GPU sans statistiques" << std::endl;
+        }
+    }
+
+    updateDragonBounds(dragon.GetHeader());
+    setupSceneShader();
+    if (options.scene == SCENE_DRAGON) setupDragonClusters();
+    if (options.scene == SCENE_INSTANCES) initializeInstances();
 
+    updateCamera();
+
+    // rechargement a chaud des sources de shaders et du mesh
+    if (options.watch) {
+        fileWatcher.Initialize();
+        std::vector<std::string> files;
+        shaderLibrary.GetSourceFiles(files);
+        files.push_back(options.meshPath);
+        for (const std::string& file : files) fileWatcher.Watch(file);
+        std::cout << "Surveillance de " << files.size() << " fichiers pour le rechargement a chaud" << std::endl;
+    }
     return true;
 }
 
-void render() {
-    glClear(GL_COLOR_BUFFER_BIT | GL_DEPTH_BUFFER_BIT);
+// copie un bloc uniforme dans le ring (envoye par le prochain Flush sans mapping persistant)
+RingAllocation allocateUniformBlock(const void* data, size_t size) {
+    RingAllocation allocation = frameRing.Allocate(size, uniformAlignment);
+    if (allocation.data) memcpy(allocation.data, data, size);
+    return allocation;
+}
 
-    float time = glfwGetTime();
+// copie un bloc uniforme dans le ring et lie sa plage tout de suite
+void pushUniformBlock(uint32_t binding, const void* data, size_t size) {
+    RingAllocation allocation = allocateUniformBlock(data, size);
+    if (!allocation.data) return;
+    frameRing.Flush();
+    frameRing.BindUniform(binding, allocation, size);
+}
 
-    // creation des matrices de transformation et de la rotation
-    Mat4 model = identityMatrix();
+// profondeur vue du centre d'un objet, pour la cle de tri
+float viewDepth(const Mat4& model) {
+    Vec4 center = transformVec4(camera.view, transformVec4(model, { 0.0f, 0.0f, 0.0f, 1.0f }));
+    return -center.z;
+}
 
+// niveau du dragon dont l'erreur, a l'echelle meshScale et a cette profondeur, reste sous options.lodError pixels
+uint32_t selectDragonLod(float depth, float meshScale) {
+    if (options.lodError <= 0.0f) return 0;
+    return dragon.SelectLod(lodPixelsPerUnit * meshScale / std::max(depth, 0.1f), options.lodError);
+}
+
+// ObjectBlock dans le ring puis paquet opaque dans la file
+void submitOpaque(uint32_t vertexArray, uint32_t count, uint32_t indexType, uint32_t instanceCount, const Mat4& model, size_t objectOffset,
+    uint32_t firstIndex = 0, uint32_t baseInstance = 0) {
+    DrawPacket packet = { sceneShader, vertexArray, GL_TRIANGLES, count, indexType, instanceCount, objectOffset, 0, 0, firstIndex, baseInstance, 0 };
+    renderQueue.Submit(makeSortKey(RENDER_PASS_OPAQUE, sceneShader->GetProgram(), vertexArray, viewDepth(model)), packet);
+}
+
+// un seul envoi du bloc camera par frame
+void uploadCamera(float time) {
+    camera.time = time;
+    pushUniformBlock(CAMERA_BLOCK_BINDING, &camera, sizeof(CameraBlock));
+}
+
+void renderCube(float time) {
+    // creation des matrices de transformation et de la rotation
     Mat4 rotationY = rotateY(time);
     Mat4 rotationX = rotateX(time * 0.5f);
     Mat4 rotationZ = rotateZ(time * 0.2f);
 
-    model = multiplyMat4(rotationZ, multiplyMat4(rotationX, rotationY));
+    Mat4 model = multiplyMat4(rotationZ, multiplyMat4(rotationX, rotationY));
+    RingAllocation object = allocateUniformBlock(&model, sizeof(ObjectBlock));
+    if (!object.data) return;
 
-    Mat4 view = translate(0.0f, 0.0f, -5.0f);
+    // dessiner le cube
+    submitOpaque(vao, 36, GL_UNSIGNED_INT, 0, model, object.offset);
 
-    Mat4 projection = perspective(45.0f * (3.14159f / 180.0f), 800.0f / 600.0f, 0.1f, 100.0f);
+    if (options.debug) debugDraw.AddBox({ -1.0f, -1.0f, -1.0f }, { 1.0f, 1.0f, 1.0f }, model, 0xFFFFFFFF);
+}
 
-    GLuint modelLoc = glGetUniformLocation(shader.m_Program, "model");
-    GLuint viewLoc = glGetUniformLocation(shader.m_Program, "view");
-    GLuint projLoc = glGetUniformLocation(shader.m_Program, "projection");
+// niveau 0 du dragon cluster par cluster, frustum et camera ramenes dans l'espace du mesh :
+// une commande indirecte par cluster visible, ou une par cluster avec instanceCount nul pour les rejetes (GPU)
+void submitDragonClusters(const Mat4& model, size_t objectOffset) {
+    Frustum frustum = extractFrustum(multiplyMat4(model, camera.viewProjection));
+    Vec3 eye = extractCameraPosition(multiplyMat4(model, camera.view));
+    DrawPacket packet = { sceneShader, dragon.m_VAO, GL_TRIANGLES, 0, dragon.GetIndexType(), 0, objectOffset, 0, 0, 0, 0, 0 };
 
-    glUniformMatrix4fv(modelLoc, 1, GL_FALSE, model.data);
-    glUniformMatrix4fv(viewLoc, 1, GL_FALSE, view.data);
-    glUniformMatrix4fv(projLoc, 1, GL_FALSE, projection.data);
+    if (options.gpuCull) {
+        {
+            GpuProfileScope scope(gpuProfiler, "culling");
+            gpuClusterCuller.Dispatch(frustum, eye);
+        }
+        if (!gpuClusterCullVerified) {
+            gpuClusterCuller.Verify(frustum, eye, dragonClusters, std::cout);
+            gpuClusterCullVerified = true;
+        }
+        packet.indirectBuffer = gpuClusterCuller.m_Commands;
+        packet.drawCount = gpuClusterCuller.GetClusterCount();
+    } else {
+        size_t visibleCount = cullClusters(frustum, eye, dragonClusters, visibleClusters.data());
+        frameBenchmark.CountCulled((uint32_t)(dragonClusters.GetCount() - visibleCount));
+        RingAllocation allocation = frameRing.Allocate(std::max<size_t>(visibleCount, 1) * sizeof(DrawElementsIndirectCommand), sizeof(uint32_t));
+        if (!allocation.data) return;
 
-    // dessiner le cube
-    glBindVertexArray(vao);
-    glDrawElements(GL_TRIANGLES, 36, GL_UNSIGNED_INT, 0);
+        DrawElementsIndirectCommand* commands = (DrawElementsIndirectCommand*)allocation.data;
+        const MeshCluster* clusters = dragon.GetClusters();
+        for (size_t i = 0; i < visibleCount; i++) {
+            const MeshCluster& cluster = clusters[visibleClusters[i]];
+            commands[i] = { cluster.indexCount, 1, cluster.indexOffset, 0, 0 };
+            packet.count += cluster.indexCount;
+        }
+        frameBenchmark.CountTrianglesCulled((dragon.GetIndexCount() - packet.count) / 3);
+        if (!visibleCount) return;
+        packet.indirectBuffer = frameRing.m_Buffer;
+        packet.drawCount = (uint32_t)visibleCount;
+        packet.indirectOffset = allocation.offset;
+    }
+    renderQueue.Submit(makeSortKey(RENDER_PASS_OPAQUE, sceneShader->GetProgram(), dragon.m_VAO, viewDepth(model)), packet);
+}
+
+// centrer le dragon sur l'origine puis le faire tourner autour de Y
+Mat4 dragonModel(float time) {
+    return multiplyMat4(translate(-dragonCenter[0], -dragonCenter[1], -dragonCenter[2]), rotateY(time * 0.5f));
+}
+
+void renderDragon(float time) {
+    Mat4 model = dragonModel(time);
+    RingAllocation object = allocateUniformBlock(&model, sizeof(ObjectBlock));
+    if (!object.data) return;
+
+    // dessiner le dragon (15 000 triangles au niveau 0, index 16 bits), au LOD choisi pour son point le plus proche
+    uint32_t level = selectDragonLod(viewDepth(identityMatrix()) - dragonRadius, 1.0f);
+    const MeshLod& lod = dragon.GetLod(level);
+    if (level == 0 && clusterCulling) submitDragonClusters(model, object.offset);
+    else submitOpaque(dragon.m_VAO, lod.indexCount, dragon.GetIndexType(), 0, model, object.offset, lod.indexOffset);
+
+    if (options.debug) {
+        const MeshFileHeader& header = dragon.GetHeader();
+        Vec3 boundsMin = { header.boundsMin[0], header.boundsMin[1], header.boundsMin[2] };
+        Vec3 boundsMax = { header.boundsMax[0], header.boundsMax[1], header.boundsMax[2] };
+        debugDraw.AddBox(boundsMin, boundsMax, model, 0xFF00FFFF);
+    }
+}
+
+// toutes les matrices sont calculees, le compute shader garde les visibles et ecrit la commande indirecte
+// le nombre d'instances dessinees reste sur le GPU
+void renderInstancesGpu(float time) {
+    size_t count = instances.GetCount();
+    RingAllocation allocation = frameRing.Allocate(count * sizeof(Mat4), instanceAlignment);
+    if (!allocation.data) return;
+
+    Mat4* models = (Mat4*)allocation.data;
+    jobSystem.ParallelFor(count, INSTANCE_JOB_GRAIN, [&](size_t begin, size_t end) {
+        PROFILE_SCOPE("update instances");
+        instances.Update(time, instanceBaseModel, models, begin, end);
+    });
+    frameRing.Flush();
+
+    Frustum frustum = extractFrustum(camera.viewProjection);
+    {
+        GpuProfileScope scope(gpuProfiler, "culling");
+        gpuCuller.Dispatch(frustum, frameRing, allocation.offset);
+    }
+    if (!gpuCullVerified) {
+        gpuCuller.Verify(frustum, instanceBounds, std::cout);
+        gpuCullVerified = true;
+    }
+
+    uint32_t vertexArray = options.instanceDragon ? dragon.m_VAO : vao;
+    uint32_t indexType = options.instanceDragon ? dragon.GetIndexType() : GL_UNSIGNED_INT;
+    DrawPacket packet = { sceneShader, vertexArray, GL_TRIANGLES, 0, indexType, 0, NO_OBJECT_BLOCK, gpuCuller.m_Commands, 1, 0, 0, 0 };
+    renderQueue.Submit(makeSortKey(RENDER_PASS_OPAQUE, sceneShader->GetProgram(), vertexArray, viewDepth(identityMatrix())), packet);
+}
+
+// regroupe les instances visibles par LOD (tri par comptage, stable) et remplit lodFirst
+const uint32_t* sortInstancesByLod(const uint32_t* visible, size_t count) {
+    const float* x = instanceBounds.GetX();
+    const float* y = instanceBounds.GetY();
+    const float* z = instanceBounds.GetZ();
+    const float* view = camera.view.data;
+    float meshScale = instanceRadius / dragonRadius;
+
+    lodFirst.assign(dragon.GetLodCount() + 1, 0);
+    for (size_t k = 0; k < count; k++) {
+        uint32_t i = visible[k];
+        float depth = -(view[2] * x[i] + view[6] * y[i] + view[10] * z[i] + view[14]) - instanceRadius;
+        lodLevels[k] = selectDragonLod(depth, meshScale);
+        lodFirst[lodLevels[k] + 1]++;
+    }
+    for (size_t level = 1; level < lodFirst.size(); level++) lodFirst[level] += lodFirst[level - 1];
+
+    // lodFirst[l] avance jusqu'a la fin du niveau l, puis tout est decale d'un cran
+    for (size_t k = 0; k < count; k++) lodInstances[lodFirst[lodLevels[k]]++] = visible[k];
+    for (size_t level = lodFirst.size() - 1; level > 0; level--) lodFirst[level] = lodFirst[level - 1];
+    lodFirst[0] = 0;
+    return lodInstances.data();
+}
+
+// rasterise les instances visibles les plus proches puis retire de visibleInstances celles qu'elles cachent
+// tout passe par les jobs pendant que le GPU traite encore les frames precedentes du ring
+size_t cullOccludedInstances(float time, size_t count) {
+    PROFILE_FUNCTION();
+    double start = glfwGetTime();
+    const float* x = instanceBounds.GetX();
+    const float* y = instanceBounds.GetY();
+    const float* z = instanceBounds.GetZ();
+    const float* view = camera.view.data;
+
+    // profondeur vue du point le plus proche de chaque sphere, les occulteurs sont les premiers
+    occluderCandidates.resize(count);
+    for (size_t k = 0; k < count; k++) {
+        uint32_t i = visibleInstances[k];
+        occluderCandidates[k] = { -(view[2] * x[i] + view[6] * y[i] + view[10] * z[i] + view[14]) - instanceRadius, i };
+    }
+    size_t occluderCount = std::min<size_t>(occlusionBuffer.GetOccluderBudget(), count);
+    std::nth_element(occluderCandidates.begin(), occluderCandidates.begin() + (occluderCount - 1), occluderCandidates.end());
+    occluderIndices.resize(occluderCount);
+    occluderModels.resize(occluderCount);
+    for (size_t k = 0; k < occluderCount; k++) occluderIndices[k] = occluderCandidates[k].second;
+    instances.UpdateVisible(time, instanceBaseModel, occluderIndices.data(), occluderModels.data(), 0, occluderCount);
+
+    occlusionBuffer.Render(jobSystem, camera.viewProjection, occluderModels.data(), occluderCount);
+    size_t visible = occlusionBuffer.Cull(jobSystem, instanceBounds, visibleInstances.data(), count);
+    frameBenchmark.CountOccluded((uint32_t)count, (uint32_t)(count - visible), (glfwGetTime() - start) * 1000.0);
+    return visible;
+}
+
+void renderInstances(float time) {
+    PROFILE_FUNCTION();
+    if (options.debug) {
+        float extent = instances.GetExtent();
+        debugDraw.AddBox({ -extent, -extent, -extent }, { extent, extent, extent }, identityMatrix(), 0xFF00FF00);
+    }
+    if (options.gpuCull) {
+        renderInstancesGpu(time);
+        return;
+    }
+
+    // seules les instances dont la sphere touche le frustum sont mises a jour et dessinees
+    size_t count = cullSpheres(extractFrustum(camera.viewProjection), instanceBounds, visibleInstances.data());
+    frameBenchmark.CountCulled((uint32_t)(instances.GetCount() - count));
+    if (occlusionCulling && count > 0) count = cullOccludedInstances(time, count);
+    if (count == 0) return;
+
+    RingAllocation allocation = frameRing.Allocate(count * sizeof(Mat4), sizeof(Mat4));
+    if (!allocation.data) return;
+
+    // models[k] est ecrit a son rang dans la liste compactee : chaque lot ecrit sa propre tranche
+    Mat4* models = (Mat4*)allocation.data;
+    const uint32_t* visible = visibleInstances.data();
+    if (instanceLods) visible = sortInstancesByLod(visible, count);
+    jobSystem.ParallelFor(count, INSTANCE_JOB_GRAIN, [&](size_t begin, size_t end) {
+        PROFILE_SCOPE("update instances");
+        instances.UpdateVisible(time, instanceBaseModel, visible, models, begin, end);
+    });
+
+    // seul l'offset dans le ring change d'une frame a l'autre (les draws par LOD partagent ces pointeurs)
+    uint32_t vertexArray = options.instanceDragon ? dragon.m_VAO : vao;
+    glState.BindVertexArray(vertexArray);
+    glState.BindBuffer(GL_ARRAY_BUFFER, frameRing.m_Buffer);
+    for (int column = 0; column < 4; column++) {
+        glVertexAttribPointer(3 + column, 4, GL_FLOAT, GL_FALSE, sizeof(Mat4), (void*)(allocation.offset + column * 4 * sizeof(float)));
+    }
+
+    // la grille est centree sur l'origine
+    if (instanceLods) {
+        for (uint32_t level = 0; level < dragon.GetLodCount(); level++) {
+            uint32_t levelCount = lodFirst[level + 1] - lodFirst[level];
+            if (levelCount == 0) continue;
+            const MeshLod& lod = dragon.GetLod(level);
+            submitOpaque(vertexArray, lod.indexCount, dragon.GetIndexType(), levelCount, identityMatrix(), NO_OBJECT_BLOCK, lod.indexOffset, lodFirst[level]);
+        }
+    } else if (options.instanceDragon) {
+        submitOpaque(vertexArray, dragon.GetIndexCount(), dragon.GetIndexType(), (uint32_t)count, identityMatrix(), NO_OBJECT_BLOCK);
+    } else {
+        submitOpaque(vertexArray, 36, GL_UNSIGNED_INT, (uint32_t)count, identityMatrix(), NO_OBJECT_BLOCK);
+    }
+}
+
+// temps GPU des frames que le profileur a pu relire
+void collectGpuTimings() {
+    for (const GpuFrameTiming& timing : gpuProfiler.TakeResults()) frameBenchmark.AddGpuFrame(timing);
+}
+
+void render(float time) {
+    PROFILE_FUNCTION();
+    glState.ResetCounters();
+    gpuProfiler.BeginFrame();
+    {
+        GpuProfileScope scope(gpuProfiler, "clear");
+        glClear(GL_COLOR_BUFFER_BIT | GL_DEPTH_BUFFER_BIT);
+    }
+    {
+        PROFILE_SCOPE("wait ring");
+        frameRing.BeginFrame();
+    }
+    frameBenchmark.AddFenceWait(frameRing.GetLastWaitMs());
+
+    uploadCamera(time);
+
+    if (options.scene == SCENE_DRAGON) {
+        renderDragon(time);
+    } else if (options.scene == SCENE_INSTANCES) {
+        renderInstances(time);
+    } else {
+        renderCube(time);
+    }
+
+    if (options.debug) debugDraw.Submit(frameRing, renderQueue);
+
+    // un seul envoi du ring puis les draws dans l'ordre des cles
+    frameRing.Flush();
+    {
+        PROFILE_SCOPE("sort queue");
+        renderQueue.Sort();
+    }
+    {
+        PROFILE_SCOPE("execute queue");
+        renderQueue.Execute(frameRing);
+    }
+    renderQueue.Clear();
+    frameRing.EndFrame();
+    gpuProfiler.EndFrame();
+    collectGpuTimings();
+    frameBenchmark.CountStateChanges(glState.GetIssuedCount(), glState.GetElidedCount());
 }
 
 void terminate() {
-    shader.Destroy();
+    dragon.Destroy();
+    jobSystem.Shutdown();
+    fileWatcher.Shutdown();
+    gpuCuller.Destroy();
+    gpuClusterCuller.Destroy();
+    shaderLibrary.Shutdown();
+    debugDraw.Destroy();
+    frameRing.Destroy();
+    gpuProfiler.Destroy();
+    if (fbo) {
+        glDeleteFramebuffers(1, &fbo);
+        glDeleteRenderbuffers(1, &fboColor);
+        glDeleteRenderbuffers(1, &fboDepth);
+    }
+    glState.ForgetVertexArray(vao);
+    glState.ForgetBuffer(vbo);
+    glState.ForgetBuffer(ebo);
     glDeleteVertexArrays(1, &vao);
     glDeleteBuffers(1, &vbo);
     glDeleteBuffers(1, &ebo);
     glfwTerminate();
 }
 
-int main() {
+// micro-benchmarks CPU, sans fenetre ni contexte GL
+int runBenchmark(const char* name) {
+    if (strcmp(name, "math") == 0) {
+        RunMathBenchmark(std::cout);
+        return 0;
+    }
+    if (strcmp(name, "jobs") == 0) {
+        RunJobBenchmark(std::cout, options.instanceCount, options.threads);
+        return 0;
+    }
+    if (strcmp(name, "queue") == 0) {
+        RunQueueBenchmark(std::cout, 100000);
+        return 0;
+    }
+    if (strcmp(name, "cull") == 0) {
+        RunCullBenchmark(std::cout, 1000000);
+        return 0;
+    }
+    if (strcmp(name, "clusters") == 0) {
+        RunClusterBenchmark(std::cout, options.meshPath);
+        return 0;
+    }
+    std::cerr << "Benchmark inconnu : " << name << std::endl;
+    return -1;
+}
+
+// remplace le dragon par la nouvelle version du fichier, l'ancienne reste en place si le chargement echoue
+void reloadMesh() {
+    Mesh mesh;
+    if (!mesh.Load(options.meshPath)) {
+        std::cerr << "Rechargement de " << options.meshPath << " echoue, ancienne version conservee" << std::endl;
+        return;
+    }
+    // la variante de shader depend du format des vertex
+    if (mesh.IsQuantized() != dragon.IsQuantized()) {
+        std::cerr << options.meshPath << " a change de format de vertex, redemarrage necessaire" << std::endl;
+        return;
+    }
+
+    dragon.Swap(mesh);
+    updateDragonBounds(dragon.GetHeader());
+    setupSceneShader();
+    if (options.scene == SCENE_DRAGON) setupDragonClusters();
+    if (options.scene == SCENE_INSTANCES && options.instanceDragon) setupInstanceMesh();
+    updateCamera();
+    std::cout << "Mesh recharge : " << options.meshPath << " (" << dragon.GetIndexCount() / 3 << " triangles)" << std::endl;
+}
+
+// entre deux frames : lance les recompilations des fichiers modifies et installe celles qui sont pretes
+void processReloads() {
+    PROFILE_FUNCTION();
+    std::vector<std::string> changed;
+    if (fileWatcher.Poll(changed)) {
+        shaderLibrary.Reload(changed);
+        if (std::find(changed.begin(), changed.end(), options.meshPath) != changed.end()) reloadMesh();
+    }
+    if (shaderLibrary.SwapReloaded() > 0) setupSceneShader();
+}
+
+// outil : compile toutes les permutations (programme x sous-ensemble de ses options)
+// pour remplir le cache de binaires avant le premier vrai lancement
+int precompileShaders() {
+    if (!initializeContext()) return -1;
+    shaderCache.SetEnabled(options.shaderCache);
+    shaderLibrary.Initialize(glfwGetCurrentContext(), options.shaderCompile);
+
+    double start = glfwGetTime();
+    for (int program = 0; program < SHADER_PROGRAM_COUNT; program++) {
+        if ((program == SHADER_CULL || program == SHADER_CLUSTER_CULL) && !GpuCuller::IsSupported()) continue;
+        uint32_t supported = ShaderLibrary::GetSupportedFeatures((ShaderProgramId)program);
+        // parcourt tous les sous-ensembles des options supportees
+        uint32_t features = 0;
+        do {
+            Material material = { (ShaderProgramId)program, features };
+            shaderLibrary.Request(material);
+            std::cout << ShaderLibrary::GetVariantName(material) << std::endl;
+            features = (features - supported) & supported;
+        } while (features != 0);
+    }
+    bool success = shaderLibrary.WaitAll();
+
+    std::cout << shaderLibrary.GetVariantCount() << " variantes en " << (glfwGetTime() - start) * 1000.0 << " ms ("
+        << shaderLibrary.GetCompileModeName() << ", " << shaderCache.GetHits() << " deja en cache)" << std::endl;
+    shaderLibrary.Shutdown();
+    glfwTerminate();
+    return success ? 0 : -1;
+}
+
+// relit le framebuffer courant (FBO en headless, back buffer sinon) avant le swap
+bool dumpFramebuffer(const char* path) {
+    PROFILE_FUNCTION();
+    std::vector<uint8_t> pixels((size_t)options.width * options.height * 4);
+    glPixelStorei(GL_PACK_ALIGNMENT, 4);
+    glReadPixels(0, 0, options.width, options.height, GL_RGBA, GL_UNSIGNED_BYTE, pixels.data());
+    return writePng(path, pixels.data(), options.width, options.height, (size_t)options.width * 4, true);
+}
+
+// zones CPU enregistrees jusqu'ici, les jobs sont au repos
+void writeTrace() {
+    if (!options.tracePath) return;
+    if (writeChromeTrace(options.tracePath)) {
+        std::cout << "Trace CPU ecrite dans " << options.tracePath << std::endl;
+    } else if (!PROFILER_ENABLED) {
+        std::cerr << "Profileur CPU absent de ce build (definir PROFILER_ENABLED=1)" << std::endl;
+    } else {
+        std::cerr << "Impossible d'ecrire " << options.tracePath << std::endl;
+    }
+}
+
+// rendu du dragon par le rasteriseur logiciel : memes fichier, matrices et eclairage que le GL, sans contexte
+int runSoftware() {
+    MeshFile mesh;
+    if (!mesh.Open(options.meshPath)) {
+        std::cerr << "Impossible de charger " << options.meshPath << std::endl;
+        return -1;
+    }
+    SoftwareRasterizer rasterizer;
+    if (!rasterizer.Create(options.width, options.height)) {
+        std::cerr << "Taille non geree par le rasteriseur logiciel (max " << RASTER_MAX_SIZE << " x " << RASTER_MAX_SIZE << ")" << std::endl;
+        return -1;
+    }
+    jobSystem.Initialize(options.threads);
+
+    // seule scene geree, au niveau 0
+    options.scene = SCENE_DRAGON;
+    updateDragonBounds(mesh.GetHeader());
+    updateCamera();
+    const MeshLod* lods = mesh.GetLods();
+    uint32_t firstIndex = lods ? lods[0].indexOffset : 0;
+    uint32_t indexCount = lods ? lods[0].indexCount : mesh.GetHeader().indexCount;
+
+    for (int frame = 0; frame < options.frames; frame++) {
+        PROFILE_SCOPE("frame");
+        frameBenchmark.BeginFrame();
+        rasterizer.Clear(0xFF000000u);
+        rasterizer.DrawMesh(jobSystem, mesh, firstIndex, indexCount, dragonModel(frame / 60.0f), camera.viewProjection);
+        frameBenchmark.CountDrawCall();
+        frameBenchmark.CountTriangles(indexCount / 3);
+        frameBenchmark.EndFrame();
+    }
+    frameBenchmark.Report(std::cout, options.perFrame);
+
+    // debit des trois etapes de DrawMesh, hors effacement
+    const RasterStats& stats = rasterizer.GetStats();
+    double drawMs = stats.vertexMs + stats.binningMs + stats.rasterMs;
+    double seconds = drawMs / 1000.0;
+    std::cout << "rasteriseur : " << jobSystem.GetThreadCount() << " threads, tuiles " << RASTER_TILE_SIZE << "x" << RASTER_TILE_SIZE
+        << ", " << (double)stats.setupTriangles / options.frames << " triangles apres rejet et decoupage par frame" << std::endl;
+    std::cout << "triangles/s : " << stats.triangles / seconds / 1e6 << " M" << std::endl;
+    std::cout << "remplissage : " << stats.pixelsWritten / seconds / 1e6 << " Mpixels/s ecrits, "
+        << stats.pixelsTested / seconds / 1e6 << " Mpixels/s testes" << std::endl;
+    std::cout << "etapes      : vertex " << stats.vertexMs / options.frames << " ms, tri par tuile " << stats.binningMs / options.frames
+        << " ms, raster " << stats.rasterMs / options.frames << " ms par frame" << std::endl;
+
+    bool dumped = !options.dumpPath || writePng(options.dumpPath, reinterpret_cast<const uint8_t*>(rasterizer.GetColor()),
+        rasterizer.GetWidth(), rasterizer.GetHeight(), rasterizer.GetRowPitch());
+    if (!dumped) std::cerr << "Impossible d'ecrire " << options.dumpPath << std::endl;
+    writeTrace();
+    jobSystem.Shutdown();
+    return dumped ? 0 : -1;
+}
+
+int main(int argc, char** argv) {
+    PROFILE_THREAD_NAME("main");
+    if (!parseOptions(argc, argv)) return -1;
+    if (options.bench) return runBenchmark(options.bench);
+    if (options.precompileShaders) return precompileShaders();
+    if (options.softwareRenderer) return runSoftware();
     if (!initialize()) return -1;
 
+    int frame = 0;
     while (!glfwWindowShouldClose(glfwGetCurrentContext())) {
-        render();
-        glfwSwapBuffers(glfwGetCurrentContext());
-        glfwPollEvents();
+        if (options.frames > 0 && frame >= options.frames) break;
+        PROFILE_SCOPE("frame");
+
+        // pas de temps fixe en benchmark pour des resultats reproductibles
+        float time = options.frames > 0 ? frame / 60.0f : (float)glfwGetTime();
+        if (options.watch) processReloads();
+
+        frameBenchmark.BeginFrame();
+        render(time);
+        if (options.dumpPath && frame + 1 == options.frames && !dumpFramebuffer(options.dumpPath)) {
+            std::cerr << "Impossible d'ecrire " << options.dumpPath << std::endl;
+        }
+        {
+            PROFILE_SCOPE("swap");
+            if (options.headless) {
+                glFinish();
+            } else {
+                glfwSwapBuffers(glfwGetCurrentContext());
+            }
+        }
+        frameBenchmark.EndFrame();
+
+        {
+            PROFILE_SCOPE("poll events");
+            glfwPollEvents();
+        }
+        frame++;
     }
 
+    // les dernieres frames sont encore dans l'anneau du profileur
+    gpuProfiler.Flush();
+    collectGpuTimings();
+    if (options.frames > 0) frameBenchmark.Report(std::cout, options.perFrame);
+    writeTrace();
+
     terminate();
     return 0;
 }
\ No newline at end of file
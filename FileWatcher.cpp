@@ -0,0 +1,110 @@
+#include "FileWatcher.h"
+#include <algorithm>
+#include <filesystem>
+#include <iostream>
+#ifdef __linux__
+#include <sys/inotify.h>
+#include <unistd.h>
+#include <cerrno>
+#endif
+
+FileWatcher::FileWatcher() {
+#ifdef __linux__
+    m_Inotify = -1;
+#endif
+}
+
+FileWatcher::~FileWatcher() {
+    Shutdown();
+}
+
+bool FileWatcher::Initialize() {
+#ifdef __linux__
+    m_Inotify = inotify_init1(IN_NONBLOCK | IN_CLOEXEC);
+    if (m_Inotify < 0) {
+        std::cerr << "inotify indisponible, surveillance par date de modification" << std::endl;
+    }
+#endif
+    return true;
+}
+
+void FileWatcher::Shutdown() {
+#ifdef __linux__
+    if (m_Inotify >= 0) close(m_Inotify);
+    m_Inotify = -1;
+    m_DirectoryWatches.clear();
+#endif
+    m_Directories.clear();
+}
+
+void FileWatcher::SplitPath(const std::string& path, std::string& directory, std::string& name) {
+    size_t slash = path.find_last_of("/\\");
+    directory = slash == std::string::npos ? "." : path.substr(0, slash);
+    name = slash == std::string::npos ? path : path.substr(slash + 1);
+}
+
+long long FileWatcher::GetWriteTime(const std::string& path) {
+    std::error_code error;
+    auto time = std::filesystem::last_write_time(path, error);
+    return error ? 0 : (long long)time.time_since_epoch().count();
+}
+
+void FileWatcher::Watch(const std::string& path) {
+    std::string directory, name;
+    SplitPath(path, directory, name);
+
+    bool newDirectory = m_Directories.find(directory) == m_Directories.end();
+    m_Directories[directory][name] = { path, GetWriteTime(path) };
+
+#ifdef __linux__
+    if (newDirectory && m_Inotify >= 0) {
+        // fin d'ecriture ou remplacement par renommage (sauvegarde atomique des editeurs)
+        int watch = inotify_add_watch(m_Inotify, directory.c_str(), IN_CLOSE_WRITE | IN_MOVED_TO | IN_CREATE);
+        if (watch >= 0) m_DirectoryWatches[watch] = directory;
+    }
+#else
+    (void)newDirectory;
+#endif
+}
+
+bool FileWatcher::Poll(std::vector<std::string>& changed) {
+    size_t before = changed.size();
+
+#ifdef __linux__
+    if (m_Inotify >= 0) {
+        alignas(inotify_event) char buffer[4096];
+        while (true) {
+            ssize_t length = read(m_Inotify, buffer, sizeof(buffer));
+            if (length <= 0) break;   // EAGAIN : plus rien en attente
+
+            for (char* cursor = buffer; cursor < buffer + length;) {
+                const inotify_event* event = (const inotify_event*)cursor;
+                cursor += sizeof(inotify_event) + event->len;
+                if (event->len == 0) continue;
+
+                auto directory = m_DirectoryWatches.find(event->wd);
+                if (directory == m_DirectoryWatches.end()) continue;
+                const auto& files = m_Directories[directory->second];
+                auto file = files.find(event->name);
+                if (file == files.end()) continue;
+
+                // plusieurs evenements pour une meme sauvegarde : un seul rechargement
+                if (std::find(changed.begin() + before, changed.end(), file->second.path) == changed.end()) {
+                    changed.push_back(file->second.path);
+                }
+            }
+        }
+        return changed.size() > before;
+    }
+#endif
+
+    for (auto& directory : m_Directories) {
+        for (auto& file : directory.second) {
+            long long writeTime = GetWriteTime(file.second.path);
+            if (writeTime == file.second.writeTime) continue;
+            file.second.writeTime = writeTime;
+            changed.push_back(file.second.path);
+        }
+    }
+    return changed.size() > before;
+}
@@ -0,0 +1,38 @@
+#pragma once
+
+#include <string>
+#include <vector>
+#include <map>
+
+// detecte les fichiers modifies sur disque pour le rechargement a chaud
+// Linux : inotify sur les dossiers parents (les editeurs remplacent souvent le fichier
+// au lieu de le reecrire) ; ailleurs : comparaison des dates de modification a chaque Poll
+class FileWatcher {
+public:
+    FileWatcher();
+    ~FileWatcher();
+
+    bool Initialize();
+    void Shutdown();
+
+    void Watch(const std::string& path);
+
+    // ajoute a changed les fichiers surveilles modifies depuis le dernier appel, sans bloquer
+    bool Poll(std::vector<std::string>& changed);
+
+private:
+    struct WatchedFile {
+        std::string path;
+        long long writeTime;   // repli sans inotify
+    };
+
+    // fichiers par dossier parent, le nom seul sert de cle
+    std::map<std::string, std::map<std::string, WatchedFile>> m_Directories;
+#ifdef __linux__
+    int m_Inotify;
+    std::map<int, std::string> m_DirectoryWatches;   // descripteur de watch -> dossier
+#endif
+
+    static void SplitPath(const std::string& path, std::string& directory, std::string& name);
+    static long long GetWriteTime(const std::string& path);
+};
@@ -1,31 +1,26 @@
 #include "GLShader.h"
+#include "ShaderCache.h"
+#include "ShaderPreprocessor.h"
+#include "GLStateCache.h"
+#include "Profiler.h"
 #include <GL/glew.h>
 #include <GL/gl.h>
+#include <algorithm>
 
-GLShader::GLShader() : m_Program(0) {}
+GLShader::GLShader() : m_Program(0), m_Stages{ 0, 0 }, m_CacheKey(0) {}
 
 GLShader::~GLShader() {
     Destroy();
 }
 
-std::string GLShader::ReadFile(const char* filePath) {
-    std::ifstream shaderFile(filePath, std::ios::in);
-    if (!shaderFile.is_open()) {
-        std::cerr << "Failed to open shader file: " << filePath << std::endl;
-        return "";
-    }
-
-    std::string shaderCode((std::istreambuf_iterator<char>(shaderFile)),
-        std::istreambuf_iterator<char>());
-    shaderFile.close();
-    return shaderCode;
-}
-
-bool GLShader::CompileShader(const char* shaderCode, uint32_t shaderType, uint32_t& shaderID) {
-    shaderID = glCreateShader(shaderType);
+uint32_t GLShader::CompileShader(const char* shaderCode, uint32_t shaderType) {
+    uint32_t shaderID = glCreateShader(shaderType);
     glShaderSource(shaderID, 1, &shaderCode, nullptr);
     glCompileShader(shaderID);
+    return shaderID;
+}
 
+bool GLShader::CheckShader(uint32_t shaderID) {
     int success;
     glGetShaderiv(shaderID, GL_COMPILE_STATUS, &success);
     if (!success) {
@@ -37,21 +32,79 @@ bool GLShader::CompileShader(const char* shaderCode, uint32_t shaderType, uint32
     return true;
 }
 
-bool GLShader::LoadShaders(const char* vertexPath, const char* fragmentPath) {
-    std::string vertexCode = ReadFile(vertexPath);
-    std::string fragmentCode = ReadFile(fragmentPath);
-    if (vertexCode.empty() || fragmentCode.empty()) return false;
+void GLShader::DeleteShaders() {
+    for (uint32_t& stage : m_Stages) {
+        if (stage) glDeleteShader(stage);
+        stage = 0;
+    }
+}
 
-    uint32_t vertexShader, fragmentShader;
-    if (!CompileShader(vertexCode.c_str(), GL_VERTEX_SHADER, vertexShader) ||
-        !CompileShader(fragmentCode.c_str(), GL_FRAGMENT_SHADER, fragmentShader)) {
-        return false;
+bool GLShader::LoadShaders(const char* vertexPath, const char* fragmentPath, const std::string& defines) {
+    PROFILE_FUNCTION();
+    return Compile(vertexPath, fragmentPath, defines) && Finish();
+}
+
+bool GLShader::Compile(const char* vertexPath, const char* fragmentPath, const std::string& defines) {
+    PROFILE_FUNCTION();
+    Destroy();
+    bool compute = !fragmentPath || !*fragmentPath;
+
+    // #include resolus et options injectees : la cle du cache couvre aussi les fichiers inclus
+    ShaderPreprocessor preprocessor;
+    std::string vertexCode, fragmentCode;
+    if (!preprocessor.Process(vertexPath, defines, vertexCode)) return false;
+    m_SourceFiles = preprocessor.GetFiles();
+    if (!compute) {
+        if (!preprocessor.Process(fragmentPath, defines, fragmentCode)) return false;
+        for (const std::string& file : preprocessor.GetFiles()) {
+            if (!DependsOn(file)) m_SourceFiles.push_back(file);
+        }
+    }
+
+    // binaire deja lie lors d'un lancement precedent : ni compilation ni edition de liens
+    m_CacheKey = shaderCache.MakeKey(vertexCode, fragmentCode);
+    m_Program = shaderCache.Load(m_CacheKey);
+    if (m_Program) return true;
+
+    if (compute) {
+        m_Stages[0] = CompileShader(vertexCode.c_str(), GL_COMPUTE_SHADER);
+    } else {
+        m_Stages[0] = CompileShader(vertexCode.c_str(), GL_VERTEX_SHADER);
+        m_Stages[1] = CompileShader(fragmentCode.c_str(), GL_FRAGMENT_SHADER);
     }
 
     m_Program = glCreateProgram();
-    glAttachShader(m_Program, vertexShader);
-    glAttachShader(m_Program, fragmentShader);
+    for (uint32_t stage : m_Stages) {
+        if (stage) glAttachShader(m_Program, stage);
+    }
+    if (shaderCache.IsAvailable()) glProgramParameteri(m_Program, GL_PROGRAM_BINARY_RETRIEVABLE_HINT, GL_TRUE);
     glLinkProgram(m_Program);
+    return true;
+}
+
+bool GLShader::IsCompiled() const {
+    if (!m_Program || !GLEW_KHR_parallel_shader_compile) return true;
+    GLint completed = GL_TRUE;
+    glGetProgramiv(m_Program, GL_COMPLETION_STATUS_KHR, &completed);
+    return completed == GL_TRUE;
+}
+
+bool GLShader::Finish() {
+    PROFILE_FUNCTION();
+    if (!m_Program) return false;
+
+    // programme venant du cache : deja lie et verifie
+    if (!m_Stages[0]) {
+        ReflectUniforms();
+        return true;
+    }
+
+    for (uint32_t stage : m_Stages) {
+        if (stage && !CheckShader(stage)) {
+            Destroy();
+            return false;
+        }
+    }
 
     int success;
     glGetProgramiv(m_Program, GL_LINK_STATUS, &success);
@@ -63,19 +116,71 @@ bool GLShader::LoadShaders(const char* vertexPath, const char* fragmentPath) {
         return false;
     }
 
-    glDeleteShader(vertexShader);
-    glDeleteShader(fragmentShader);
+    DeleteShaders();
+    shaderCache.Store(m_CacheKey, m_Program);
+    ReflectUniforms();
+    return true;
+}
+
+void GLShader::ReflectUniforms() {
+    m_Uniforms.clear();
+
+    int count = 0, maxLength = 0;
+    glGetProgramiv(m_Program, GL_ACTIVE_UNIFORMS, &count);
+    glGetProgramiv(m_Program, GL_ACTIVE_UNIFORM_MAX_LENGTH, &maxLength);
+
+    std::string name(maxLength, '\0');
+    for (int i = 0; i < count; i++) {
+        GLsizei length = 0;
+        GLint size = 0;
+        GLenum type = 0;
+        glGetActiveUniform(m_Program, i, maxLength, &length, &size, &type, &name[0]);
+
+        std::string uniformName = name.substr(0, length);
+        GLint location = glGetUniformLocation(m_Program, uniformName.c_str());
+        // les membres de blocs uniformes n'ont pas de location
+        if (location < 0) continue;
+
+        m_Uniforms[uniformName] = location;
+        // un tableau est aussi accessible sans le suffixe [0]
+        size_t bracket = uniformName.find("[0]");
+        if (bracket != std::string::npos) m_Uniforms[uniformName.substr(0, bracket)] = location;
+    }
+}
+
+int32_t GLShader::GetUniformLocation(const std::string& name) const {
+    auto it = m_Uniforms.find(name);
+    return it != m_Uniforms.end() ? it->second : -1;
+}
 
+bool GLShader::BindUniformBlock(const std::string& name, uint32_t binding) const {
+    GLuint index = glGetUniformBlockIndex(m_Program, name.c_str());
+    if (index == GL_INVALID_INDEX) return false;
+    glUniformBlockBinding(m_Program, index, binding);
     return true;
 }
 
+bool GLShader::DependsOn(const std::string& path) const {
+    return std::find(m_SourceFiles.begin(), m_SourceFiles.end(), path) != m_SourceFiles.end();
+}
+
+void GLShader::Swap(GLShader& other) {
+    std::swap(m_Program, other.m_Program);
+    std::swap(m_Stages, other.m_Stages);
+    std::swap(m_CacheKey, other.m_CacheKey);
+    m_Uniforms.swap(other.m_Uniforms);
+    m_SourceFiles.swap(other.m_SourceFiles);
+}
+
 void GLShader::Use() const {
-    glUseProgram(m_Program);
+    glState.UseProgram(m_Program);
 }
 
 void GLShader::Destroy() {
+    DeleteShaders();
     if (m_Program) {
         glDeleteProgram(m_Program);
         m_Program = 0;
     }
+    m_Uniforms.clear();
 }
@@ -4,6 +4,8 @@
 #include <string>
 #include <fstream>
 #include <iostream>
+#include <unordered_map>
+#include <vector>
 
 class GLShader {
 public:
@@ -14,11 +16,38 @@ public:
 
     uint32_t GetProgram() const { return m_Program; }
 
-    bool LoadShaders(const char* vertexPath, const char* fragmentPath);
+    bool LoadShaders(const char* vertexPath, const char* fragmentPath, const std::string& defines = "");
+
+    // chargement en deux temps : Compile soumet compilation et edition de liens sans lire
+    // les statuts (ce qui forcerait le driver a finir), Finish les verifie et reflechit les uniforms
+    // sans fragmentPath (nullptr ou ""), vertexPath est un compute shader seul
+    bool Compile(const char* vertexPath, const char* fragmentPath, const std::string& defines = "");
+    bool IsCompiled() const;   // GL_COMPLETION_STATUS_KHR, toujours vrai sans l'extension
+    bool Finish();
+
+    // fichiers lus a la compilation (sources et #include), pour le rechargement a chaud
+    const std::vector<std::string>& GetSourceFiles() const { return m_SourceFiles; }
+    bool DependsOn(const std::string& path) const;
+
+    // echange les programmes : les pointeurs vers ce GLShader voient la nouvelle version
+    void Swap(GLShader& other);
     void Use() const;
     void Destroy();
 
+    // location reflechie a l'edition de liens, -1 si l'uniform n'est pas actif
+    int32_t GetUniformLocation(const std::string& name) const;
+
+    // associe un bloc uniforme a un point de liaison, false si le bloc n'est pas actif
+    bool BindUniformBlock(const std::string& name, uint32_t binding) const;
+
 private:
-    bool CompileShader(const char* shaderCode, uint32_t shaderType, uint32_t& shaderID);
-    std::string ReadFile(const char* filePath);
+    std::unordered_map<std::string, int32_t> m_Uniforms;
+    std::vector<std::string> m_SourceFiles;
+    uint32_t m_Stages[2];   // vertex + fragment, ou compute seul (0 une fois lies)
+    uint64_t m_CacheKey;
+
+    void ReflectUniforms();
+    uint32_t CompileShader(const char* shaderCode, uint32_t shaderType);
+    bool CheckShader(uint32_t shaderID);
+    void DeleteShaders();
 };
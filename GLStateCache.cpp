@@ -0,0 +1,111 @@
+#include "GLStateCache.h"
+#include <GL/glew.h>
+#include <GL/gl.h>
+
+GLStateCache glState;
+
+GLStateCache::GLStateCache() : m_Issued(0), m_Elided(0) {
+    Invalidate();
+}
+
+void GLStateCache::Invalidate() {
+    m_Program = UNKNOWN;
+    m_VertexArray = UNKNOWN;
+    for (uint32_t& buffer : m_Buffers) buffer = UNKNOWN;
+    for (BufferRange& range : m_UniformRanges) range = { UNKNOWN, 0, 0 };
+    for (int8_t& capability : m_Capabilities) capability = -1;
+}
+
+void GLStateCache::ResetCounters() {
+    m_Issued = 0;
+    m_Elided = 0;
+}
+
+// compte l'appel et indique s'il faut le transmettre
+bool GLStateCache::Track(bool changed) {
+    if (changed) m_Issued++;
+    else m_Elided++;
+    return changed;
+}
+
+int GLStateCache::GetBufferSlot(uint32_t target) {
+    switch (target) {
+    case GL_ARRAY_BUFFER: return 0;
+    case GL_COPY_WRITE_BUFFER: return 1;
+    case GL_UNIFORM_BUFFER: return 2;
+    default: return -1;
+    }
+}
+
+int GLStateCache::GetCapabilitySlot(uint32_t capability) {
+    switch (capability) {
+    case GL_DEPTH_TEST: return 0;
+    case GL_CULL_FACE: return 1;
+    case GL_BLEND: return 2;
+    case GL_SCISSOR_TEST: return 3;
+    default: return -1;
+    }
+}
+
+void GLStateCache::UseProgram(uint32_t program) {
+    // un programme supprime reste en place tant qu'il est utilise : son nom ne peut pas etre reattribue
+    if (!Track(m_Program != program)) return;
+    m_Program = program;
+    glUseProgram(program);
+}
+
+void GLStateCache::BindVertexArray(uint32_t vertexArray) {
+    if (!Track(m_VertexArray != vertexArray)) return;
+    m_VertexArray = vertexArray;
+    glBindVertexArray(vertexArray);
+}
+
+void GLStateCache::BindBuffer(uint32_t target, uint32_t buffer) {
+    int slot = GetBufferSlot(target);
+    if (!Track(slot < 0 || m_Buffers[slot] != buffer)) return;
+    if (slot >= 0) m_Buffers[slot] = buffer;
+    glBindBuffer(target, buffer);
+}
+
+void GLStateCache::BindBufferRange(uint32_t target, uint32_t index, uint32_t buffer, size_t offset, size_t size) {
+    if (target != GL_UNIFORM_BUFFER || index >= UNIFORM_BINDING_COUNT) {
+        Track(true);
+        glBindBufferRange(target, index, buffer, offset, size);
+        return;
+    }
+    BufferRange& range = m_UniformRanges[index];
+    if (!Track(range.buffer != buffer || range.offset != offset || range.size != size)) return;
+    range = { buffer, offset, size };
+    // glBindBufferRange modifie aussi le point de liaison generique
+    m_Buffers[GetBufferSlot(GL_UNIFORM_BUFFER)] = buffer;
+    glBindBufferRange(target, index, buffer, offset, size);
+}
+
+void GLStateCache::SetCapability(uint32_t capability, bool enabled) {
+    int slot = GetCapabilitySlot(capability);
+    if (!Track(slot < 0 || m_Capabilities[slot] != (int8_t)enabled)) return;
+    if (slot >= 0) m_Capabilities[slot] = enabled;
+    if (enabled) glEnable(capability);
+    else glDisable(capability);
+}
+
+void GLStateCache::Enable(uint32_t capability) {
+    SetCapability(capability, true);
+}
+
+void GLStateCache::Disable(uint32_t capability) {
+    SetCapability(capability, false);
+}
+
+void GLStateCache::ForgetVertexArray(uint32_t vertexArray) {
+    if (m_VertexArray == vertexArray) m_VertexArray = 0;
+}
+
+void GLStateCache::ForgetBuffer(uint32_t buffer) {
+    for (uint32_t& bound : m_Buffers) {
+        if (bound == buffer) bound = 0;
+    }
+    for (BufferRange& range : m_UniformRanges) {
+        if (range.buffer == buffer) range = { 0, 0, 0 };
+    }
+}
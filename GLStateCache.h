@@ -0,0 +1,58 @@
+#pragma once
+
+#include <cstdint>
+#include <cstddef>
+
+// copie CPU de l'etat GL courant : un changement d'etat deja en place n'est pas transmis au driver
+// tout le code de rendu passe par l'instance globale glState, sinon la copie n'est plus fiable
+class GLStateCache {
+public:
+    GLStateCache();
+
+    void UseProgram(uint32_t program);
+    void BindVertexArray(uint32_t vertexArray);
+    // GL_ELEMENT_ARRAY_BUFFER fait partie du VAO : il est toujours transmis
+    void BindBuffer(uint32_t target, uint32_t buffer);
+    void BindBufferRange(uint32_t target, uint32_t index, uint32_t buffer, size_t offset, size_t size);
+    void Enable(uint32_t capability);
+    void Disable(uint32_t capability);
+
+    // a appeler avant glDelete* : GL delie l'objet supprime et son nom peut etre reattribue
+    void ForgetVertexArray(uint32_t vertexArray);
+    void ForgetBuffer(uint32_t buffer);
+    // apres des appels GL qui contournent le cache
+    void Invalidate();
+
+    // compteurs depuis le dernier ResetCounters (une frame)
+    uint32_t GetIssuedCount() const { return m_Issued; }
+    uint32_t GetElidedCount() const { return m_Elided; }
+    void ResetCounters();
+
+private:
+    static const uint32_t UNKNOWN = 0xFFFFFFFF;
+    static const int BUFFER_TARGET_COUNT = 3;
+    static const int UNIFORM_BINDING_COUNT = 16;
+    static const int CAPABILITY_COUNT = 4;
+
+    struct BufferRange {
+        uint32_t buffer;
+        size_t offset;
+        size_t size;
+    };
+
+    uint32_t m_Program;
+    uint32_t m_VertexArray;
+    uint32_t m_Buffers[BUFFER_TARGET_COUNT];
+    BufferRange m_UniformRanges[UNIFORM_BINDING_COUNT];
+    int8_t m_Capabilities[CAPABILITY_COUNT];   // -1 inconnu, 0 desactive, 1 active
+    uint32_t m_Issued;
+    uint32_t m_Elided;
+
+    bool Track(bool changed);
+    void SetCapability(uint32_t capability, bool enabled);
+    static int GetBufferSlot(uint32_t target);
+    static int GetCapabilitySlot(uint32_t capability);
+};
+
+// instance globale pour le contexte principal (le contexte du compilateur de shaders ne lie rien)
+extern GLStateCache glState;
@@ -0,0 +1,187 @@
+#include "GpuCulling.h"
+#include "GLStateCache.h"
+#include <GL/glew.h>
+#include <GL/gl.h>
+#include <algorithm>
+#include <vector>
+
+GpuCuller::GpuCuller() : m_VisibleModels(0), m_Commands(0), m_Shader(nullptr), m_Bounds(0), m_VisibleIndices(0), m_ObjectCount(0), m_IndexCount(0) {}
+
+GpuCuller::~GpuCuller() {
+    Destroy();
+}
+
+bool GpuCuller::IsSupported() {
+    return GLEW_ARB_compute_shader && GLEW_ARB_shader_storage_buffer_object && GLEW_ARB_multi_draw_indirect;
+}
+
+size_t GpuCuller::GetStorageOffsetAlignment() {
+    GLint alignment = 16;
+    glGetIntegerv(GL_SHADER_STORAGE_BUFFER_OFFSET_ALIGNMENT, &alignment);
+    return (size_t)alignment;
+}
+
+void GpuCuller::SubmitShaders(ShaderLibrary& library) {
+    m_Shader = library.Request({ SHADER_CULL, 0 });
+}
+
+// buffer GPU de size octets, rempli avec data si non nul
+static uint32_t createStorage(size_t size, const void* data) {
+    uint32_t buffer = 0;
+    glGenBuffers(1, &buffer);
+    glState.BindBuffer(GL_COPY_WRITE_BUFFER, buffer);
+    glBufferData(GL_COPY_WRITE_BUFFER, size, data, data ? GL_STATIC_DRAW : GL_DYNAMIC_COPY);
+    return buffer;
+}
+
+bool GpuCuller::Create(const SphereBounds& bounds, uint32_t indexCount) {
+    Destroy();
+    if (!m_Shader || !m_Shader->GetProgram()) return false;
+    m_ObjectCount = (uint32_t)bounds.GetCount();
+    m_IndexCount = indexCount;
+
+    // le shader lit une sphere par vec4 : les tableaux SoA sont entrelaces une fois pour toutes
+    std::vector<float> spheres(m_ObjectCount * 4);
+    for (uint32_t i = 0; i < m_ObjectCount; i++) {
+        spheres[i * 4 + 0] = bounds.GetX()[i];
+        spheres[i * 4 + 1] = bounds.GetY()[i];
+        spheres[i * 4 + 2] = bounds.GetZ()[i];
+        spheres[i * 4 + 3] = bounds.GetRadius()[i];
+    }
+    size_t count = std::max<size_t>(m_ObjectCount, 1);
+    m_Bounds = createStorage(count * 4 * sizeof(float), spheres.data());
+    m_VisibleModels = createStorage(count * sizeof(Mat4), nullptr);
+    m_VisibleIndices = createStorage(count * sizeof(uint32_t), nullptr);
+    m_Commands = createStorage(sizeof(DrawElementsIndirectCommand), nullptr);
+    return true;
+}
+
+void GpuCuller::Destroy() {
+    for (uint32_t* buffer : { &m_Bounds, &m_VisibleModels, &m_VisibleIndices, &m_Commands }) {
+        if (!*buffer) continue;
+        glState.ForgetBuffer(*buffer);
+        glDeleteBuffers(1, buffer);
+        *buffer = 0;
+    }
+    m_ObjectCount = 0;
+}
+
+void GpuCuller::Dispatch(const Frustum& frustum, const RingBuffer& ring, size_t modelsOffset) {
+    // instanceCount remis a zero, incremente par le shader
+    DrawElementsIndirectCommand command = { m_IndexCount, 0, 0, 0, 0 };
+    glState.BindBuffer(GL_COPY_WRITE_BUFFER, m_Commands);
+    glBufferSubData(GL_COPY_WRITE_BUFFER, 0, sizeof(command), &command);
+
+    m_Shader->Use();
+    glUniform4fv(m_Shader->GetUniformLocation("frustumPlanes"), 6, &frustum.planes[0].x);
+    glUniform1ui(m_Shader->GetUniformLocation("objectCount"), m_ObjectCount);
+
+    glBindBufferBase(GL_SHADER_STORAGE_BUFFER, 0, m_Bounds);
+    glBindBufferRange(GL_SHADER_STORAGE_BUFFER, 1, ring.m_Buffer, modelsOffset, m_ObjectCount * sizeof(Mat4));
+    glBindBufferBase(GL_SHADER_STORAGE_BUFFER, 2, m_VisibleModels);
+    glBindBufferBase(GL_SHADER_STORAGE_BUFFER, 3, m_VisibleIndices);
+    glBindBufferBase(GL_SHADER_STORAGE_BUFFER, 4, m_Commands);
+    glDispatchCompute((m_ObjectCount + 63) / 64, 1, 1);
+
+    // la commande et les matrices sont lues par le draw qui suit
+    glMemoryBarrier(GL_COMMAND_BARRIER_BIT | GL_VERTEX_ATTRIB_ARRAY_BARRIER_BIT);
+}
+
+bool GpuCuller::Verify(const Frustum& frustum, const SphereBounds& bounds, std::ostream& out) const {
+    glMemoryBarrier(GL_BUFFER_UPDATE_BARRIER_BIT);
+    DrawElementsIndirectCommand command = {};
+    glState.BindBuffer(GL_COPY_WRITE_BUFFER, m_Commands);
+    glGetBufferSubData(GL_COPY_WRITE_BUFFER, 0, sizeof(command), &command);
+
+    std::vector<uint32_t> gpuVisible(command.instanceCount);
+    glState.BindBuffer(GL_COPY_WRITE_BUFFER, m_VisibleIndices);
+    glGetBufferSubData(GL_COPY_WRITE_BUFFER, 0, gpuVisible.size() * sizeof(uint32_t), gpuVisible.data());
+    // l'ordre des atomiques n'est pas defini : seul l'ensemble est compare
+    std::sort(gpuVisible.begin(), gpuVisible.end());
+
+    std::vector<uint32_t> cpuVisible(bounds.GetCount());
+    cpuVisible.resize(cullSpheres(frustum, bounds, cpuVisible.data()));
+
+    bool identical = gpuVisible == cpuVisible;
+    out << "Culling GPU : " << gpuVisible.size() << " instances visibles sur " << bounds.GetCount();
+    if (identical) out << ", identique au CPU";
+    else out << ", different du CPU (" << cpuVisible.size() << " visibles)";
+    out << std::endl;
+    return identical;
+}
+
+GpuClusterCuller::GpuClusterCuller() : m_Commands(0), m_Shader(nullptr), m_Clusters(0), m_ClusterCount(0) {}
+
+GpuClusterCuller::~GpuClusterCuller() {
+    Destroy();
+}
+
+void GpuClusterCuller::SubmitShaders(ShaderLibrary& library) {
+    m_Shader = library.Request({ SHADER_CLUSTER_CULL, 0 });
+}
+
+bool GpuClusterCuller::Create(const ClusterBounds& bounds, const MeshCluster* clusters) {
+    Destroy();
+    if (!m_Shader || !m_Shader->GetProgram()) return false;
+    m_ClusterCount = (uint32_t)bounds.GetCount();
+
+    // memes valeurs que les tableaux SoA du CPU
+    const SphereBounds& spheres = bounds.GetSpheres();
+    std::vector<GpuClusterData> data(std::max<size_t>(m_ClusterCount, 1));
+    for (uint32_t i = 0; i < m_ClusterCount; i++) {
+        data[i] = {
+            { spheres.GetX()[i], spheres.GetY()[i], spheres.GetZ()[i], spheres.GetRadius()[i] },
+            { bounds.GetApexX()[i], bounds.GetApexY()[i], bounds.GetApexZ()[i] }, clusters[i].indexOffset,
+            { bounds.GetConeX()[i], bounds.GetConeY()[i], bounds.GetConeZ()[i], bounds.GetConeCutoffSquared()[i] },
+            clusters[i].indexCount, { 0, 0, 0 }
+        };
+    }
+    m_Clusters = createStorage(data.size() * sizeof(GpuClusterData), data.data());
+    m_Commands = createStorage(data.size() * sizeof(DrawElementsIndirectCommand), nullptr);
+    return true;
+}
+
+void GpuClusterCuller::Destroy() {
+    for (uint32_t* buffer : { &m_Clusters, &m_Commands }) {
+        if (!*buffer) continue;
+        glState.ForgetBuffer(*buffer);
+        glDeleteBuffers(1, buffer);
+        *buffer = 0;
+    }
+    m_ClusterCount = 0;
+}
+
+void GpuClusterCuller::Dispatch(const Frustum& frustum, const Vec3& camera) {
+    // toutes les commandes sont reecrites, pas de remise a zero
+    m_Shader->Use();
+    glUniform4fv(m_Shader->GetUniformLocation("frustumPlanes"), 6, &frustum.planes[0].x);
+    glUniform3f(m_Shader->GetUniformLocation("cameraPosition"), camera.x, camera.y, camera.z);
+    glUniform1ui(m_Shader->GetUniformLocation("clusterCount"), m_ClusterCount);
+
+    glBindBufferBase(GL_SHADER_STORAGE_BUFFER, 0, m_Clusters);
+    glBindBufferBase(GL_SHADER_STORAGE_BUFFER, 1, m_Commands);
+    glDispatchCompute((m_ClusterCount + 63) / 64, 1, 1);
+
+    glMemoryBarrier(GL_COMMAND_BARRIER_BIT);
+}
+
+bool GpuClusterCuller::Verify(const Frustum& frustum, const Vec3& camera, const ClusterBounds& bounds, std::ostream& out) const {
+    glMemoryBarrier(GL_BUFFER_UPDATE_BARRIER_BIT);
+    std::vector<DrawElementsIndirectCommand> commands(m_ClusterCount);
+    glState.BindBuffer(GL_COPY_WRITE_BUFFER, m_Commands);
+    glGetBufferSubData(GL_COPY_WRITE_BUFFER, 0, commands.size() * sizeof(DrawElementsIndirectCommand), commands.data());
+
+    std::vector<uint32_t> gpuVisible;
+    for (uint32_t i = 0; i < m_ClusterCount; i++) {
+        if (commands[i].instanceCount) gpuVisible.push_back(i);
+    }
+    std::vector<uint32_t> cpuVisible(bounds.GetCount());
+    cpuVisible.resize(cullClusters(frustum, camera, bounds, cpuVisible.data()));
+
+    bool identical = gpuVisible == cpuVisible;
+    out << "Culling des clusters sur GPU : " << gpuVisible.size() << " clusters visibles sur " << m_ClusterCount;
+    if (identical) out << ", identique au CPU";
+    else out << ", different du CPU (" << cpuVisible.size() << " visibles)";
+    out << std::endl;
+    return identical;
+}
@@ -0,0 +1,92 @@
+#pragma once
+
+#include "Culling.h"
+#include "MeshFile.h"
+#include "RingBuffer.h"
+#include "ShaderLibrary.h"
+#include <cstdint>
+#include <cstddef>
+#include <iostream>
+
+// miroir de la commande lue par glMultiDrawElementsIndirect
+struct DrawElementsIndirectCommand {
+    uint32_t count;
+    uint32_t instanceCount;
+    uint32_t firstIndex;
+    int32_t baseVertex;
+    uint32_t baseInstance;
+};
+
+// culling des instances par un compute shader : les matrices visibles sont compactees dans
+// m_VisibleModels et le nombre d'instances ecrit directement dans la commande indirecte,
+// le CPU ne lit rien en retour et dessine toute la scene en un appel
+class GpuCuller {
+public:
+    uint32_t m_VisibleModels;   // source des attributs d'instance (locations 3 a 6)
+    uint32_t m_Commands;        // GL_DRAW_INDIRECT_BUFFER
+
+    GpuCuller();
+    ~GpuCuller();
+
+    // compute shaders, SSBO et draw indirect multiples (GL 4.3)
+    static bool IsSupported();
+
+    void SubmitShaders(ShaderLibrary& library);
+    // spheres copiees une fois sur le GPU, indexCount : index par instance dans la commande
+    bool Create(const SphereBounds& bounds, uint32_t indexCount);
+    void Destroy();
+
+    // models : matrices de toutes les instances, dans le ring a modelsOffset (aligne pour un SSBO)
+    void Dispatch(const Frustum& frustum, const RingBuffer& ring, size_t modelsOffset);
+
+    // relit le resultat du dernier Dispatch (bloquant) et le compare a cullSpheres sur CPU
+    bool Verify(const Frustum& frustum, const SphereBounds& bounds, std::ostream& out) const;
+
+    // alignement des offsets de glBindBufferRange(GL_SHADER_STORAGE_BUFFER)
+    static size_t GetStorageOffsetAlignment();
+
+private:
+    GLShader* m_Shader;   // variante possedee par la ShaderLibrary
+    uint32_t m_Bounds;
+    uint32_t m_VisibleIndices;
+    uint32_t m_ObjectCount;
+    uint32_t m_IndexCount;
+};
+
+// un cluster tel que lu par ClusterCull.cs (std430)
+struct GpuClusterData {
+    float sphere[4];       // centre, rayon
+    float apex[3];
+    uint32_t firstIndex;
+    float cone[4];         // axe, cutoff^2
+    uint32_t indexCount;
+    uint32_t padding[3];
+};
+
+// culling des clusters d'un mesh par un compute shader : une commande indirecte par cluster,
+// instanceCount mis a 0 pour les clusters rejetes ; un seul glMultiDrawElementsIndirect dessine le reste
+class GpuClusterCuller {
+public:
+    uint32_t m_Commands;   // GL_DRAW_INDIRECT_BUFFER, GetClusterCount() commandes
+
+    GpuClusterCuller();
+    ~GpuClusterCuller();
+
+    void SubmitShaders(ShaderLibrary& library);
+    // bornes copiees une fois sur le GPU, clusters : plages d'index dans le meme ordre
+    bool Create(const ClusterBounds& bounds, const MeshCluster* clusters);
+    void Destroy();
+
+    // frustum et camera dans l'espace du mesh
+    void Dispatch(const Frustum& frustum, const Vec3& camera);
+
+    // relit les commandes du dernier Dispatch (bloquant) et les compare a cullClusters sur CPU
+    bool Verify(const Frustum& frustum, const Vec3& camera, const ClusterBounds& bounds, std::ostream& out) const;
+
+    uint32_t GetClusterCount() const { return m_ClusterCount; }
+
+private:
+    GLShader* m_Shader;
+    uint32_t m_Clusters;
+    uint32_t m_ClusterCount;
+};
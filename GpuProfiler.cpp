@@ -0,0 +1,145 @@
+#include "GpuProfiler.h"
+#include <GL/glew.h>
+#include <GL/gl.h>
+#include <algorithm>
+
+GpuProfiler gpuProfiler;
+
+static const GLenum STATISTIC_TARGETS[GPU_STAT_COUNT] = {
+    GL_VERTICES_SUBMITTED_ARB,
+    GL_PRIMITIVES_SUBMITTED_ARB,
+    GL_FRAGMENT_SHADER_INVOCATIONS_ARB
+};
+
+GpuProfiler::GpuProfiler() : m_Enabled(false), m_Statistics(false), m_InFrame(false), m_InPass(false), m_Frame(0), m_Frames() {}
+
+GpuProfiler::~GpuProfiler() {
+    Destroy();
+}
+
+bool GpuProfiler::IsSupported() {
+    return GLEW_VERSION_3_3 || GLEW_ARB_timer_query;
+}
+
+bool GpuProfiler::HasPipelineStatistics() {
+    return GLEW_ARB_pipeline_statistics_query;
+}
+
+bool GpuProfiler::Create(bool statistics) {
+    Destroy();
+    if (!IsSupported()) return false;
+    m_Statistics = statistics && HasPipelineStatistics();
+    for (FrameQueries& frame : m_Frames) glGenQueries(2, frame.timestamps);
+    m_Frame = 0;
+    m_Enabled = true;
+    return true;
+}
+
+void GpuProfiler::Destroy() {
+    if (!m_Enabled) return;
+    for (FrameQueries& frame : m_Frames) {
+        glDeleteQueries(2, frame.timestamps);
+        for (PassQueries& pass : frame.passes) {
+            glDeleteQueries(1, &pass.elapsed);
+            if (m_Statistics) glDeleteQueries(GPU_STAT_COUNT, pass.statistics);
+        }
+        frame = FrameQueries();
+    }
+    m_Results.clear();
+    m_Enabled = false;
+    m_InFrame = false;
+    m_InPass = false;
+}
+
+void GpuProfiler::BeginFrame() {
+    if (!m_Enabled) return;
+    FrameQueries& frame = m_Frames[m_Frame % GPU_PROFILER_LATENCY];
+    // posee GPU_PROFILER_LATENCY frames plus tot : deja disponible sauf si le GPU est tres en retard
+    if (frame.pending) Resolve(frame);
+    frame.frame = m_Frame;
+    frame.passCount = 0;
+    glQueryCounter(frame.timestamps[0], GL_TIMESTAMP);
+    m_InFrame = true;
+}
+
+void GpuProfiler::EndFrame() {
+    if (!m_InFrame) return;
+    if (m_InPass) EndPass();
+    FrameQueries& frame = m_Frames[m_Frame % GPU_PROFILER_LATENCY];
+    glQueryCounter(frame.timestamps[1], GL_TIMESTAMP);
+    frame.pending = true;
+    m_InFrame = false;
+    m_Frame++;
+}
+
+void GpuProfiler::BeginPass(const char* name) {
+    if (!m_InFrame || m_InPass) return;
+    FrameQueries& frame = m_Frames[m_Frame % GPU_PROFILER_LATENCY];
+
+    // les requetes d'une place de l'anneau sont creees a la premiere frame qui en a besoin
+    if (frame.passCount == frame.passes.size()) {
+        PassQueries pass = {};
+        glGenQueries(1, &pass.elapsed);
+        if (m_Statistics) glGenQueries(GPU_STAT_COUNT, pass.statistics);
+        frame.passes.push_back(pass);
+    }
+    PassQueries& pass = frame.passes[frame.passCount];
+    pass.name = name;
+    glBeginQuery(GL_TIME_ELAPSED, pass.elapsed);
+    if (m_Statistics) {
+        for (int stat = 0; stat < GPU_STAT_COUNT; stat++) glBeginQuery(STATISTIC_TARGETS[stat], pass.statistics[stat]);
+    }
+    m_InPass = true;
+}
+
+void GpuProfiler::EndPass() {
+    if (!m_InPass) return;
+    glEndQuery(GL_TIME_ELAPSED);
+    if (m_Statistics) {
+        for (int stat = 0; stat < GPU_STAT_COUNT; stat++) glEndQuery(STATISTIC_TARGETS[stat]);
+    }
+    m_Frames[m_Frame % GPU_PROFILER_LATENCY].passCount++;
+    m_InPass = false;
+}
+
+void GpuProfiler::Resolve(FrameQueries& frame) {
+    GpuFrameTiming timing;
+    timing.frame = frame.frame;
+    GLuint64 begin = 0, end = 0;
+    glGetQueryObjectui64v(frame.timestamps[0], GL_QUERY_RESULT, &begin);
+    glGetQueryObjectui64v(frame.timestamps[1], GL_QUERY_RESULT, &end);
+    timing.ms = (end - begin) / 1e6;
+
+    timing.passes.resize(frame.passCount);
+    for (size_t i = 0; i < frame.passCount; i++) {
+        const PassQueries& queries = frame.passes[i];
+        GpuPassTiming& pass = timing.passes[i];
+        GLuint64 elapsed = 0;
+        glGetQueryObjectui64v(queries.elapsed, GL_QUERY_RESULT, &elapsed);
+        pass.name = queries.name;
+        // une passe ne peut pas depasser sa frame (premiere requete incoherente sur certains drivers)
+        pass.ms = std::min(elapsed / 1e6, timing.ms);
+        for (int stat = 0; stat < GPU_STAT_COUNT; stat++) {
+            GLuint64 value = 0;
+            if (m_Statistics) glGetQueryObjectui64v(queries.statistics[stat], GL_QUERY_RESULT, &value);
+            pass.statistics[stat] = value;
+        }
+    }
+    m_Results.push_back(std::move(timing));
+    frame.pending = false;
+}
+
+void GpuProfiler::Flush() {
+    if (!m_Enabled) return;
+    // de la plus ancienne a la plus recente
+    for (uint32_t i = 0; i < GPU_PROFILER_LATENCY; i++) {
+        FrameQueries& frame = m_Frames[(m_Frame + i) % GPU_PROFILER_LATENCY];
+        if (frame.pending) Resolve(frame);
+    }
+}
+
+std::vector<GpuFrameTiming> GpuProfiler::TakeResults() {
+    std::vector<GpuFrameTiming> results;
+    results.swap(m_Results);
+    return results;
+}
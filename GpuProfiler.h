@@ -0,0 +1,103 @@
+#pragma once
+
+#include <cstdint>
+#include <cstddef>
+#include <vector>
+
+// frames en vol dans l'anneau de requetes : une frame n'est relue que GPU_PROFILER_LATENCY frames plus tard,
+// quand le GPU l'a terminee depuis longtemps (une de plus que les regions du RingBuffer)
+const uint32_t GPU_PROFILER_LATENCY = 4;
+
+// compteurs ARB_pipeline_statistics_query
+enum GpuStatistic {
+    GPU_STAT_VERTICES,     // vertex soumis
+    GPU_STAT_PRIMITIVES,   // primitives soumises
+    GPU_STAT_FRAGMENTS,    // invocations du fragment shader
+    GPU_STAT_COUNT
+};
+
+struct GpuPassTiming {
+    const char* name;   // chaine statique passee a BeginPass
+    double ms;
+    uint64_t statistics[GPU_STAT_COUNT];   // 0 sans statistiques
+};
+
+struct GpuFrameTiming {
+    uint64_t frame;   // numero de la frame depuis Create
+    double ms;        // du debut de la premiere commande a la fin de la derniere (GL_TIMESTAMP)
+    std::vector<GpuPassTiming> passes;
+};
+
+// profileur GPU par passes nommees : GL_TIME_ELAPSED autour de chaque passe, GL_TIMESTAMP en debut et fin de
+// frame, et en option les statistiques du pipeline par passe ; les requetes d'une frame sont relues quand
+// sa place dans l'anneau revient, sans attendre le GPU
+class GpuProfiler {
+public:
+    GpuProfiler();
+    ~GpuProfiler();
+
+    // GL 3.3 ou ARB_timer_query ; statistics ignore sans ARB_pipeline_statistics_query
+    static bool IsSupported();
+    static bool HasPipelineStatistics();
+
+    bool Create(bool statistics);
+    void Destroy();
+    bool IsEnabled() const { return m_Enabled; }
+    bool IsCollectingStatistics() const { return m_Statistics; }
+
+    // BeginFrame relit la frame qui occupait la meme place dans l'anneau
+    void BeginFrame();
+    void EndFrame();
+
+    // passes non imbriquees (une seule requete GL_TIME_ELAPSED active a la fois), name doit rester valide ;
+    // hors d'une frame ou dans une passe deja ouverte l'appel est ignore
+    void BeginPass(const char* name);
+    void EndPass();
+
+    // relit toutes les frames encore en vol (bloquant), a appeler avant le rapport
+    void Flush();
+
+    // frames relues depuis le dernier appel, dans l'ordre
+    std::vector<GpuFrameTiming> TakeResults();
+
+private:
+    struct PassQueries {
+        const char* name;
+        uint32_t elapsed;
+        uint32_t statistics[GPU_STAT_COUNT];
+    };
+
+    // une frame de l'anneau, les requetes sont gardees d'un tour a l'autre
+    struct FrameQueries {
+        uint64_t frame;
+        bool pending;
+        uint32_t timestamps[2];
+        std::vector<PassQueries> passes;
+        size_t passCount;   // passes utilisees par la frame en cours
+    };
+
+    bool m_Enabled;
+    bool m_Statistics;
+    bool m_InFrame;
+    bool m_InPass;
+    uint64_t m_Frame;
+    FrameQueries m_Frames[GPU_PROFILER_LATENCY];
+    std::vector<GpuFrameTiming> m_Results;
+
+    void Resolve(FrameQueries& frame);
+};
+
+// passe mesuree jusqu'a la fin du bloc
+class GpuProfileScope {
+public:
+    GpuProfileScope(GpuProfiler& profiler, const char* name) : m_Profiler(profiler) { m_Profiler.BeginPass(name); }
+    ~GpuProfileScope() { m_Profiler.EndPass(); }
+    GpuProfileScope(const GpuProfileScope&) = delete;
+    GpuProfileScope& operator=(const GpuProfileScope&) = delete;
+
+private:
+    GpuProfiler& m_Profiler;
+};
+
+// instance globale, inactive tant que Create n'a pas reussi (BeginPass / EndPass ne font alors rien)
+extern GpuProfiler gpuProfiler;
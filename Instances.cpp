@@ -0,0 +1,56 @@
+#include "Instances.h"
+#include <cmath>
+
+// generateur pseudo-aleatoire deterministe pour des benchmarks reproductibles
+static float nextRandom(uint32_t& state) {
+    state = state * 1664525u + 1013904223u;
+    return (state >> 8) * (1.0f / 16777216.0f);
+}
+
+void InstanceSet::Generate(uint32_t count, float spacing, uint32_t seed) {
+    m_Instances.resize(count);
+
+    // grille cubique centree sur l'origine
+    uint32_t side = (uint32_t)ceil(cbrt((double)count));
+    float half = 0.5f * (side - 1) * spacing;
+    uint32_t state = seed;
+
+    for (uint32_t i = 0; i < count; i++) {
+        InstanceData& instance = m_Instances[i];
+        instance.offset.x = (i % side) * spacing - half;
+        instance.offset.y = ((i / side) % side) * spacing - half;
+        instance.offset.z = (i / (side * side)) * spacing - half;
+        instance.speed.x = 2.0f * nextRandom(state) - 1.0f;
+        instance.speed.y = 2.0f * nextRandom(state) - 1.0f;
+        instance.speed.z = 2.0f * nextRandom(state) - 1.0f;
+    }
+
+    m_Extent = half + spacing;
+    m_Radius = sqrtf(3.0f) * m_Extent;
+}
+
+Mat4 InstanceSet::ComputeModel(const InstanceData& instance, float time, const Mat4& baseModel) const {
+    Mat4 rotationY = rotateY(time * instance.speed.y);
+    Mat4 rotationX = rotateX(time * instance.speed.x);
+    Mat4 rotationZ = rotateZ(time * instance.speed.z);
+
+    Mat4 rotation = multiplyMat4(baseModel, multiplyMat4(rotationZ, multiplyMat4(rotationX, rotationY)));
+    return multiplyMat4(rotation, translate(instance.offset.x, instance.offset.y, instance.offset.z));
+}
+
+void InstanceSet::Update(float time, const Mat4& baseModel, Mat4* models, size_t begin, size_t end) const {
+    for (size_t i = begin; i < end; i++) {
+        models[i] = ComputeModel(m_Instances[i], time, baseModel);
+    }
+}
+
+void InstanceSet::UpdateVisible(float time, const Mat4& baseModel, const uint32_t* indices, Mat4* models, size_t begin, size_t end) const {
+    for (size_t k = begin; k < end; k++) {
+        models[k] = ComputeModel(m_Instances[indices[k]], time, baseModel);
+    }
+}
+
+void InstanceSet::GetBounds(float radius, SphereBounds& bounds) const {
+    bounds.Clear();
+    for (const InstanceData& instance : m_Instances) bounds.Add(instance.offset, radius);
+}
@@ -0,0 +1,39 @@
+#pragma once
+
+#include "MathUtils.h"
+#include "Culling.h"
+#include <cstdint>
+#include <cstddef>
+#include <vector>
+
+// parametres d'animation d'une instance
+struct InstanceData {
+    Vec3 offset;    // position dans la grille
+    Vec3 speed;     // vitesses de rotation autour de X, Y et Z
+};
+
+// ensemble d'objets identiques disposes en grille, chacun avec sa propre rotation
+class InstanceSet {
+public:
+    void Generate(uint32_t count, float spacing, uint32_t seed = 1);
+
+    // calcule les matrices model des instances [begin, end) pour l'instant time
+    // baseModel est applique avant la rotation (centrage / mise a l'echelle du mesh)
+    void Update(float time, const Mat4& baseModel, Mat4* models, size_t begin, size_t end) const;
+    // idem pour les instances indices[begin, end) : models[k] recoit la matrice de l'instance indices[k]
+    void UpdateVisible(float time, const Mat4& baseModel, const uint32_t* indices, Mat4* models, size_t begin, size_t end) const;
+
+    // une sphere de rayon radius par instance : la rotation se fait sur place, les spheres ne bougent pas
+    void GetBounds(float radius, SphereBounds& bounds) const;
+
+    size_t GetCount() const { return m_Instances.size(); }
+    float GetRadius() const { return m_Radius; }   // rayon de la sphere englobant la grille
+    float GetExtent() const { return m_Extent; }   // demi-cote du cube englobant la grille
+
+private:
+    std::vector<InstanceData> m_Instances;
+
+    Mat4 ComputeModel(const InstanceData& instance, float time, const Mat4& baseModel) const;
+    float m_Radius = 0.0f;
+    float m_Extent = 0.0f;
+};
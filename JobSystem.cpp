@@ -0,0 +1,107 @@
+#include "JobSystem.h"
+#include "Profiler.h"
+#include <algorithm>
+
+JobSystem::JobSystem() : m_Running(false), m_Queued(0), m_Pending(0) {}
+
+JobSystem::~JobSystem() {
+    Shutdown();
+}
+
+void JobSystem::Initialize(uint32_t threadCount) {
+    Shutdown();
+    if (threadCount == 0) threadCount = std::max(1u, std::thread::hardware_concurrency());
+
+    for (uint32_t i = 0; i < threadCount; i++) m_Queues.push_back(std::make_unique<WorkQueue>());
+
+    // la file 0 appartient au thread appelant, les autres a un worker chacune
+    m_Running = true;
+    for (uint32_t i = 1; i < threadCount; i++) m_Workers.emplace_back(&JobSystem::WorkerLoop, this, i);
+}
+
+void JobSystem::Shutdown() {
+    {
+        std::lock_guard<std::mutex> lock(m_WakeMutex);
+        m_Running = false;
+    }
+    m_Wake.notify_all();
+    for (std::thread& worker : m_Workers) worker.join();
+    m_Workers.clear();
+    m_Queues.clear();
+}
+
+void JobSystem::ParallelFor(size_t count, size_t grain, const std::function<void(size_t begin, size_t end)>& body) {
+    if (count == 0) return;
+    grain = std::max<size_t>(grain, 1);
+
+    // sans worker, ou pour un seul lot, inutile de passer par les files
+    uint32_t threadCount = GetThreadCount();
+    if (threadCount <= 1 || count <= grain) {
+        body(0, count);
+        return;
+    }
+
+    // lots repartis en tourniquet, le vol equilibre ensuite la charge
+    // compteurs incrementes avant publication pour qu'aucun job ne les fasse passer sous zero
+    size_t batchCount = (count + grain - 1) / grain;
+    m_Pending += (uint32_t)batchCount;
+    {
+        std::lock_guard<std::mutex> lock(m_WakeMutex);
+        m_Queued += (uint32_t)batchCount;
+    }
+    for (size_t batch = 0; batch < batchCount; batch++) {
+        size_t begin = batch * grain;
+        size_t end = std::min(count, begin + grain);
+        WorkQueue& queue = *m_Queues[batch % threadCount];
+        std::lock_guard<std::mutex> lock(queue.mutex);
+        queue.jobs.push_back([&body, begin, end] { body(begin, end); });
+    }
+    m_Wake.notify_all();
+
+    // le thread appelant participe puis attend les lots encore en cours ailleurs
+    while (m_Pending > 0) {
+        if (!RunOne(0)) std::this_thread::yield();
+    }
+}
+
+void JobSystem::WorkerLoop(uint32_t index) {
+    PROFILE_THREAD_NAME("worker", (int)index);
+    while (true) {
+        if (RunOne(index)) continue;
+
+        std::unique_lock<std::mutex> lock(m_WakeMutex);
+        m_Wake.wait(lock, [this] { return !m_Running || m_Queued > 0; });
+        if (!m_Running) return;
+    }
+}
+
+bool JobSystem::RunOne(uint32_t index) {
+    Job job;
+    if (!Pop(index, job) && !Steal(index, job)) return false;
+    m_Queued--;
+    job();
+    m_Pending--;
+    return true;
+}
+
+bool JobSystem::Pop(uint32_t index, Job& job) {
+    WorkQueue& queue = *m_Queues[index];
+    std::lock_guard<std::mutex> lock(queue.mutex);
+    if (queue.jobs.empty()) return false;
+    job = std::move(queue.jobs.back());
+    queue.jobs.pop_back();
+    return true;
+}
+
+bool JobSystem::Steal(uint32_t index, Job& job) {
+    uint32_t threadCount = GetThreadCount();
+    for (uint32_t offset = 1; offset < threadCount; offset++) {
+        WorkQueue& queue = *m_Queues[(index + offset) % threadCount];
+        std::lock_guard<std::mutex> lock(queue.mutex);
+        if (queue.jobs.empty()) continue;
+        job = std::move(queue.jobs.front());
+        queue.jobs.pop_front();
+        return true;
+    }
+    return false;
+}
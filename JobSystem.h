@@ -0,0 +1,51 @@
+#pragma once
+
+#include <cstdint>
+#include <cstddef>
+#include <atomic>
+#include <deque>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <condition_variable>
+#include <thread>
+#include <vector>
+
+// pool de threads fixe a vol de travail : chaque thread a sa propre file,
+// il depile par la fin et vole par le debut des files des autres quand la sienne est vide
+class JobSystem {
+public:
+    using Job = std::function<void()>;
+
+    JobSystem();
+    ~JobSystem();
+
+    // threadCount inclut le thread appelant (0 = nombre de coeurs)
+    void Initialize(uint32_t threadCount = 0);
+    void Shutdown();
+
+    // decoupe [0, count) en lots d'au plus grain elements et attend la fin de tous les lots
+    // le thread appelant (file 0) travaille aussi ; a n'appeler que depuis ce thread
+    void ParallelFor(size_t count, size_t grain, const std::function<void(size_t begin, size_t end)>& body);
+
+    uint32_t GetThreadCount() const { return (uint32_t)m_Queues.size(); }
+
+private:
+    struct WorkQueue {
+        std::mutex mutex;
+        std::deque<Job> jobs;
+    };
+
+    std::vector<std::unique_ptr<WorkQueue>> m_Queues;
+    std::vector<std::thread> m_Workers;
+    std::atomic<bool> m_Running;
+    std::atomic<uint32_t> m_Queued;    // jobs en file, pas encore pris
+    std::atomic<uint32_t> m_Pending;   // jobs pas encore termines
+    std::mutex m_WakeMutex;
+    std::condition_variable m_Wake;
+
+    void WorkerLoop(uint32_t index);
+    bool RunOne(uint32_t index);
+    bool Pop(uint32_t index, Job& job);
+    bool Steal(uint32_t index, Job& job);
+};
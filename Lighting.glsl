@@ -0,0 +1,15 @@
+// modele d'eclairage : diffus seul par defaut, speculaire Blinn-Phong avec BLINN_PHONG
+const vec3 lightDir = vec3(0.4, 0.8, 0.45);
+
+vec3 shade(vec3 albedo, vec3 normal, vec3 viewDir) {
+    vec3 n = normalize(normal);
+    vec3 l = normalize(lightDir);
+    float ndotl = dot(n, l);
+    float diffuse = max(ndotl, 0.0);
+    vec3 color = albedo * (0.2 + 0.8 * diffuse);
+#ifdef BLINN_PHONG
+    vec3 h = normalize(l + normalize(viewDir));
+    color += vec3(0.35) * pow(max(dot(n, h), 0.0), 32.0) * (ndotl > 0.0 ? 1.0 : 0.0);
+#endif
+    return color;
+}
@@ -0,0 +1,201 @@
+#include "MathUtils.h"
+#include <cmath>
+
+#if defined(MATH_SIMD_SSE)
+#include <immintrin.h>
+#elif defined(MATH_SIMD_NEON)
+#include <arm_neon.h>
+#endif
+
+Mat4 identityMatrix() {
+    Mat4 mat = {
+        1, 0, 0, 0,
+        0, 1, 0, 0,
+        0, 0, 1, 0,
+        0, 0, 0, 1
+    };
+    return mat;
+}
+
+Mat4 translate(float x, float y, float z) {
+    Mat4 mat = identityMatrix();
+    mat.data[12] = x;
+    mat.data[13] = y;
+    mat.data[14] = z;
+    return mat;
+}
+
+Mat4 scale(float x, float y, float z) {
+    Mat4 mat = identityMatrix();
+    mat.data[0] = x;
+    mat.data[5] = y;
+    mat.data[10] = z;
+    return mat;
+}
+
+Mat4 perspective(float fov, float aspect, float near, float far) {
+    Mat4 mat = { 0 };
+    float tanHalfFOV = tan(fov / 2.0f);
+    mat.data[0] = 1.0f / (aspect * tanHalfFOV);
+    mat.data[5] = 1.0f / tanHalfFOV;
+    mat.data[10] = -(far + near) / (far - near);
+    mat.data[11] = -1.0f;
+    mat.data[14] = -(2.0f * far * near) / (far - near);
+    return mat;
+}
+
+Mat4 rotateY(float angle) {
+    Mat4 mat = identityMatrix();
+    mat.data[0] = cos(angle);
+    mat.data[2] = sin(angle);
+    mat.data[8] = -sin(angle);
+    mat.data[10] = cos(angle);
+    return mat;
+}
+
+Mat4 rotateX(float angle) {
+    Mat4 mat = identityMatrix();
+    mat.data[5] = cos(angle);
+    mat.data[6] = -sin(angle);
+    mat.data[9] = sin(angle);
+    mat.data[10] = cos(angle);
+    return mat;
+}
+
+Mat4 rotateZ(float angle) {
+    Mat4 mat = identityMatrix();
+    mat.data[0] = cos(angle);
+    mat.data[1] = -sin(angle);
+    mat.data[4] = sin(angle);
+    mat.data[5] = cos(angle);
+    return mat;
+}
+
+Mat4 multiplyMat4Scalar(const Mat4& a, const Mat4& b) {
+    Mat4 result = { 0 };
+    for (int i = 0; i < 4; i++) {
+        for (int j = 0; j < 4; j++) {
+            result.data[i * 4 + j] =
+                a.data[i * 4 + 0] * b.data[0 * 4 + j] +
+                a.data[i * 4 + 1] * b.data[1 * 4 + j] +
+                a.data[i * 4 + 2] * b.data[2 * 4 + j] +
+                a.data[i * 4 + 3] * b.data[3 * 4 + j];
+        }
+    }
+    return result;
+}
+
+// chaque ligne du resultat est une combinaison lineaire des 4 lignes de b :
+// result[i] = a[i][0] * b[0] + a[i][1] * b[1] + a[i][2] * b[2] + a[i][3] * b[3]
+// SSE meme en build AVX : deux lignes par registre 256 bits allongeaient la latence d'une chaine de produits
+Mat4 multiplyMat4(const Mat4& a, const Mat4& b) {
+    Mat4 result;
+#if defined(MATH_SIMD_SSE)
+    __m128 b0 = _mm_load_ps(&b.data[0]);
+    __m128 b1 = _mm_load_ps(&b.data[4]);
+    __m128 b2 = _mm_load_ps(&b.data[8]);
+    __m128 b3 = _mm_load_ps(&b.data[12]);
+    for (int i = 0; i < 16; i += 4) {
+        __m128 row = _mm_load_ps(&a.data[i]);
+        __m128 r = _mm_mul_ps(_mm_shuffle_ps(row, row, 0x00), b0);
+        r = _mm_add_ps(r, _mm_mul_ps(_mm_shuffle_ps(row, row, 0x55), b1));
+        r = _mm_add_ps(r, _mm_mul_ps(_mm_shuffle_ps(row, row, 0xAA), b2));
+        r = _mm_add_ps(r, _mm_mul_ps(_mm_shuffle_ps(row, row, 0xFF), b3));
+        _mm_store_ps(&result.data[i], r);
+    }
+#elif defined(MATH_SIMD_NEON)
+    float32x4_t b0 = vld1q_f32(&b.data[0]);
+    float32x4_t b1 = vld1q_f32(&b.data[4]);
+    float32x4_t b2 = vld1q_f32(&b.data[8]);
+    float32x4_t b3 = vld1q_f32(&b.data[12]);
+    for (int i = 0; i < 16; i += 4) {
+        float32x4_t row = vld1q_f32(&a.data[i]);
+        float32x4_t r = vmulq_laneq_f32(b0, row, 0);
+        r = vfmaq_laneq_f32(r, b1, row, 1);
+        r = vfmaq_laneq_f32(r, b2, row, 2);
+        r = vfmaq_laneq_f32(r, b3, row, 3);
+        vst1q_f32(&result.data[i], r);
+    }
+#else
+    result = multiplyMat4Scalar(a, b);
+#endif
+    return result;
+}
+
+// m * v = somme des colonnes de m ponderees par les composantes de v
+Vec4 transformVec4(const Mat4& m, const Vec4& v) {
+    Vec4 result;
+#if defined(MATH_SIMD_SSE)
+    __m128 r = _mm_mul_ps(_mm_load_ps(&m.data[0]), _mm_set1_ps(v.x));
+    r = _mm_add_ps(r, _mm_mul_ps(_mm_load_ps(&m.data[4]), _mm_set1_ps(v.y)));
+    r = _mm_add_ps(r, _mm_mul_ps(_mm_load_ps(&m.data[8]), _mm_set1_ps(v.z)));
+    r = _mm_add_ps(r, _mm_mul_ps(_mm_load_ps(&m.data[12]), _mm_set1_ps(v.w)));
+    _mm_store_ps(&result.x, r);
+#elif defined(MATH_SIMD_NEON)
+    float32x4_t r = vmulq_n_f32(vld1q_f32(&m.data[0]), v.x);
+    r = vfmaq_n_f32(r, vld1q_f32(&m.data[4]), v.y);
+    r = vfmaq_n_f32(r, vld1q_f32(&m.data[8]), v.z);
+    r = vfmaq_n_f32(r, vld1q_f32(&m.data[12]), v.w);
+    vst1q_f32(&result.x, r);
+#else
+    const float* c = m.data;
+    result.x = c[0] * v.x + c[4] * v.y + c[8] * v.z + c[12] * v.w;
+    result.y = c[1] * v.x + c[5] * v.y + c[9] * v.z + c[13] * v.w;
+    result.z = c[2] * v.x + c[6] * v.y + c[10] * v.z + c[14] * v.w;
+    result.w = c[3] * v.x + c[7] * v.y + c[11] * v.z + c[15] * v.w;
+#endif
+    return result;
+}
+
+void transformVec4Batch(const Mat4& m, const Vec4* input, Vec4* output, size_t count) {
+#if defined(MATH_SIMD_SSE)
+    // colonnes chargees une seule fois pour tout le lot
+    __m128 c0 = _mm_load_ps(&m.data[0]);
+    __m128 c1 = _mm_load_ps(&m.data[4]);
+    __m128 c2 = _mm_load_ps(&m.data[8]);
+    __m128 c3 = _mm_load_ps(&m.data[12]);
+    for (size_t i = 0; i < count; i++) {
+        __m128 v = _mm_load_ps(&input[i].x);
+        __m128 r = _mm_mul_ps(c0, _mm_shuffle_ps(v, v, 0x00));
+        r = _mm_add_ps(r, _mm_mul_ps(c1, _mm_shuffle_ps(v, v, 0x55)));
+        r = _mm_add_ps(r, _mm_mul_ps(c2, _mm_shuffle_ps(v, v, 0xAA)));
+        r = _mm_add_ps(r, _mm_mul_ps(c3, _mm_shuffle_ps(v, v, 0xFF)));
+        _mm_store_ps(&output[i].x, r);
+    }
+#else
+    for (size_t i = 0; i < count; i++) output[i] = transformVec4(m, input[i]);
+#endif
+}
+
+void multiplyMat4Batch(const Mat4* input, const Mat4& m, Mat4* output, size_t count) {
+#if defined(MATH_SIMD_AVX)
+    __m256 b0 = _mm256_broadcast_ps((const __m128*)&m.data[0]);
+    __m256 b1 = _mm256_broadcast_ps((const __m128*)&m.data[4]);
+    __m256 b2 = _mm256_broadcast_ps((const __m128*)&m.data[8]);
+    __m256 b3 = _mm256_broadcast_ps((const __m128*)&m.data[12]);
+    for (size_t n = 0; n < count; n++) {
+        for (int i = 0; i < 16; i += 8) {
+            __m256 rows = _mm256_load_ps(&input[n].data[i]);
+            __m256 r = _mm256_mul_ps(_mm256_shuffle_ps(rows, rows, 0x00), b0);
+            r = _mm256_add_ps(r, _mm256_mul_ps(_mm256_shuffle_ps(rows, rows, 0x55), b1));
+            r = _mm256_add_ps(r, _mm256_mul_ps(_mm256_shuffle_ps(rows, rows, 0xAA), b2));
+            r = _mm256_add_ps(r, _mm256_mul_ps(_mm256_shuffle_ps(rows, rows, 0xFF), b3));
+            _mm256_store_ps(&output[n].data[i], r);
+        }
+    }
+#else
+    for (size_t n = 0; n < count; n++) output[n] = multiplyMat4(input[n], m);
+#endif
+}
+
+const char* mathSimdName() {
+#if defined(MATH_SIMD_AVX)
+    return "AVX";
+#elif defined(MATH_SIMD_SSE)
+    return "SSE";
+#elif defined(MATH_SIMD_NEON)
+    return "NEON";
+#else
+    return "scalaire";
+#endif
+}
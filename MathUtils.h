@@ -0,0 +1,70 @@
+#pragma once
+
+#include <cstddef>
+
+// jeu d'instructions SIMD choisi a la compilation
+#if defined(__AVX__)
+#define MATH_SIMD_AVX 1
+#define MATH_SIMD_SSE 1
+#elif defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#define MATH_SIMD_SSE 1
+#elif defined(__ARM_NEON) && defined(__aarch64__)
+#define MATH_SIMD_NEON 1
+#endif
+
+#if defined(MATH_SIMD_AVX)
+#define MATH_ALIGNMENT 32
+#else
+#define MATH_ALIGNMENT 16
+#endif
+
+// structure pour un vecteur 3D
+struct Vec3 {
+    float x, y, z;
+};
+
+// vecteur homogene, aligne pour les chargements SIMD
+struct alignas(16) Vec4 {
+    float x, y, z, w;
+};
+
+// structure pour une matrice 4x4 (colonnes contigues, comme attendu par glUniformMatrix4fv)
+struct alignas(MATH_ALIGNMENT) Mat4 {
+    float data[16];
+};
+
+// fonction pour creer une matrice identite
+Mat4 identityMatrix();
+
+// fonction pour creer une matrice de translation
+Mat4 translate(float x, float y, float z);
+
+// fonction pour creer une matrice de mise a l'echelle
+Mat4 scale(float x, float y, float z);
+
+// fonction pour creer une matrice de projection en perspective
+Mat4 perspective(float fov, float aspect, float near, float far);
+
+// fonctions pour creer des matrices de rotation autour des axes Y, X et Z
+Mat4 rotateY(float angle);
+Mat4 rotateX(float angle);
+Mat4 rotateZ(float angle);
+
+// fonction pour multiplier deux matrices 4x4 (SIMD si disponible)
+// multiplyMat4(a, b) applique a puis b : equivaut a b * a en notation mathematique
+Mat4 multiplyMat4(const Mat4& a, const Mat4& b);
+
+// version scalaire de reference
+Mat4 multiplyMat4Scalar(const Mat4& a, const Mat4& b);
+
+// transforme un vecteur homogene par une matrice (m * v)
+Vec4 transformVec4(const Mat4& m, const Vec4& v);
+
+// transforme un tableau de vecteurs, output peut etre egal a input
+void transformVec4Batch(const Mat4& m, const Vec4* input, Vec4* output, size_t count);
+
+// multiplie un tableau de matrices par une meme matrice : output[i] = multiplyMat4(input[i], m)
+void multiplyMat4Batch(const Mat4* input, const Mat4& m, Mat4* output, size_t count);
+
+// nom du chemin SIMD compile, pour les rapports de benchmark
+const char* mathSimdName();
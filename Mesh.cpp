@@ -0,0 +1,98 @@
+#include "Mesh.h"
+#include "GLStateCache.h"
+#include <GL/glew.h>
+#include <GL/gl.h>
+#include <utility>
+
+Mesh::Mesh() : m_VAO(0), m_VBO(0), m_EBO(0), m_Header(), m_Lods(1, MeshLod()) {}
+
+Mesh::~Mesh() {
+    Destroy();
+}
+
+bool Mesh::Load(const char* path) {
+    MeshFile file;
+    if (!file.Open(path)) return false;
+
+    Destroy();
+    m_Header = file.GetHeader();
+    if (m_Header.lodCount) m_Lods.assign(file.GetLods(), file.GetLods() + m_Header.lodCount);
+    else m_Lods.assign(1, { 0, m_Header.indexCount, 0.0f, 0 });
+    m_Clusters.assign(file.GetClusters(), file.GetClusters() + m_Header.clusterCount);
+
+    // le VAO du mesh garde le lien avec l'EBO
+    glGenVertexArrays(1, &m_VAO);
+    glState.BindVertexArray(m_VAO);
+
+    // upload direct depuis les pages mappees, sans copie intermediaire
+    glGenBuffers(1, &m_VBO);
+    glState.BindBuffer(GL_ARRAY_BUFFER, m_VBO);
+    glBufferData(GL_ARRAY_BUFFER, file.GetVertexBytes(), file.GetVertices(), GL_STATIC_DRAW);
+    SetupVertexLayout();
+
+    glGenBuffers(1, &m_EBO);
+    glState.BindBuffer(GL_ELEMENT_ARRAY_BUFFER, m_EBO);
+    glBufferData(GL_ELEMENT_ARRAY_BUFFER, file.GetIndexBytes(), file.GetIndices(), GL_STATIC_DRAW);
+
+    glState.BindVertexArray(0);
+    return true;
+}
+
+// position, normale et UV sur les locations 0, 1 et 2
+void Mesh::SetupVertexLayout() {
+    GLsizei stride = m_Header.vertexStride;
+
+    if (IsQuantized()) {
+        // decompresse par le vertex shader (variante QUANTIZED de Mesh.vs)
+        glVertexAttribPointer(0, 3, GL_SHORT, GL_TRUE, stride, (void*)0);
+        glEnableVertexAttribArray(0);
+
+        glVertexAttribPointer(1, 2, GL_SHORT, GL_TRUE, stride, (void*)8);
+        glEnableVertexAttribArray(1);
+
+        glVertexAttribPointer(2, 2, GL_UNSIGNED_SHORT, GL_TRUE, stride, (void*)12);
+        glEnableVertexAttribArray(2);
+        return;
+    }
+
+    glVertexAttribPointer(0, 3, GL_FLOAT, GL_FALSE, stride, (void*)0);
+    glEnableVertexAttribArray(0);
+
+    glVertexAttribPointer(1, 3, GL_FLOAT, GL_FALSE, stride, (void*)(3 * sizeof(float)));
+    glEnableVertexAttribArray(1);
+
+    glVertexAttribPointer(2, 2, GL_FLOAT, GL_FALSE, stride, (void*)(6 * sizeof(float)));
+    glEnableVertexAttribArray(2);
+}
+
+void Mesh::Swap(Mesh& other) {
+    std::swap(m_VAO, other.m_VAO);
+    std::swap(m_VBO, other.m_VBO);
+    std::swap(m_EBO, other.m_EBO);
+    std::swap(m_Header, other.m_Header);
+    std::swap(m_Lods, other.m_Lods);
+    std::swap(m_Clusters, other.m_Clusters);
+}
+
+uint32_t Mesh::SelectLod(float pixelsPerUnit, float maxPixelError) const {
+    for (uint32_t level = (uint32_t)m_Lods.size() - 1; level > 0; level--) {
+        if (m_Lods[level].error * pixelsPerUnit <= maxPixelError) return level;
+    }
+    return 0;
+}
+
+uint32_t Mesh::GetIndexType() const {
+    return m_Header.indexSize == 2 ? GL_UNSIGNED_SHORT : GL_UNSIGNED_INT;
+}
+
+void Mesh::Destroy() {
+    glState.ForgetVertexArray(m_VAO);
+    glState.ForgetBuffer(m_VBO);
+    glState.ForgetBuffer(m_EBO);
+    if (m_VAO) glDeleteVertexArrays(1, &m_VAO);
+    if (m_VBO) glDeleteBuffers(1, &m_VBO);
+    if (m_EBO) glDeleteBuffers(1, &m_EBO);
+    m_VAO = 0;
+    m_VBO = 0;
+    m_EBO = 0;
+}
@@ -0,0 +1,14 @@
+#version 330 core
+
+in vec3 fragNormal;
+in vec2 fragTexCoord;
+in vec3 fragViewDir;
+out vec4 outColor;
+
+#include "Lighting.glsl"
+
+void main() {
+    // teinte legerement variee par les UV
+    vec3 albedo = vec3(0.35 + 0.3 * fragTexCoord.x, 0.55, 0.35 + 0.3 * fragTexCoord.y);
+    outColor = vec4(shade(albedo, fragNormal, fragViewDir), 1.0);
+}
@@ -0,0 +1,44 @@
+#pragma once
+
+#include "MeshFile.h"
+#include <cstdint>
+#include <vector>
+
+// mesh charge depuis un fichier .mesh et envoye dans un VBO/EBO
+class Mesh {
+public:
+    uint32_t m_VAO;
+    uint32_t m_VBO;
+    uint32_t m_EBO;
+
+    Mesh();
+    ~Mesh();
+
+    bool Load(const char* path);
+    void Destroy();
+
+    // echange les buffers : remplace un mesh en place apres rechargement
+    void Swap(Mesh& other);
+
+    uint32_t GetVertexCount() const { return m_Header.vertexCount; }
+    // index du niveau 0 ; les LOD suivants sont a la suite dans le meme EBO
+    uint32_t GetIndexCount() const { return m_Lods[0].indexCount; }
+    uint32_t GetLodCount() const { return (uint32_t)m_Lods.size(); }
+    const MeshLod& GetLod(uint32_t level) const { return m_Lods[level]; }
+    // niveau le plus grossier dont l'erreur projetee reste sous maxPixelError
+    // pixelsPerUnit : taille a l'ecran d'une unite du mesh, a sa distance de la camera
+    uint32_t SelectLod(float pixelsPerUnit, float maxPixelError) const;
+    // clusters du niveau 0, vide pour les fichiers de version < 3
+    uint32_t GetClusterCount() const { return (uint32_t)m_Clusters.size(); }
+    const MeshCluster* GetClusters() const { return m_Clusters.data(); }
+    uint32_t GetIndexType() const;
+    bool IsQuantized() const { return m_Header.vertexFormat == MESH_VERTEX_PACKED16; }
+    const MeshFileHeader& GetHeader() const { return m_Header; }
+
+private:
+    MeshFileHeader m_Header;
+    std::vector<MeshLod> m_Lods;
+    std::vector<MeshCluster> m_Clusters;
+
+    void SetupVertexLayout();
+};
@@ -0,0 +1,34 @@
+#version 330 core
+layout(location = 0) in vec3 position;
+#ifdef QUANTIZED
+layout(location = 1) in vec2 normal;   // normale encodee en octaedre
+#else
+layout(location = 1) in vec3 normal;
+#endif
+layout(location = 2) in vec2 texCoord;
+
+out vec3 fragNormal;
+out vec2 fragTexCoord;
+out vec3 fragViewDir;
+
+#include "Camera.glsl"
+#include "Object.glsl"
+#include "Quantization.glsl"
+
+void main() {
+#ifdef QUANTIZED
+    vec3 objectPosition = meshCenter + position * meshExtent;
+    vec3 objectNormal = decodeOctahedral(normal);
+#else
+    vec3 objectPosition = position;
+    vec3 objectNormal = normal;
+#endif
+    vec4 worldPosition = model * vec4(objectPosition, 1.0);
+    gl_Position = viewProjection * worldPosition;
+    fragNormal = mat3(model) * objectNormal;
+    fragTexCoord = texCoord;
+
+    // position de la camera en repere monde : -R^T * t
+    vec3 cameraPosition = -transpose(mat3(view)) * view[3].xyz;
+    fragViewDir = cameraPosition - worldPosition.xyz;
+}
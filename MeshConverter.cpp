@@ -0,0 +1,242 @@
+#include "MeshFile.h"
+#include "MeshOptimizer.h"
+#include "DragonData.h"
+#include "CubeData.h"
+#include <iostream>
+#include <cstring>
+#include <cfloat>
+#include <cmath>
+#include <vector>
+#include <algorithm>
+#include <glm/glm.hpp>
+#include <glm/gtc/packing.hpp>
+
+// outil hors ligne : convertit DragonData.h en fichier binaire Dragon.mesh
+// seul ce programme inclut DragonData.h, l'application charge le fichier par mmap
+
+const uint32_t FLOATS_PER_VERTEX = 8;
+
+// vertex compresse, decode par la variante QUANTIZED de Mesh.vs
+struct PackedVertex {
+    uint64_t position;  // snorm16 x4, relative au centre / demi-etendue de l'AABB (w inutilise)
+    uint32_t normal;    // snorm16 x2, encodage octaedrique
+    uint32_t texCoord;  // unorm16 x2
+};
+
+static_assert(sizeof(PackedVertex) == 16, "PackedVertex doit faire 16 octets");
+
+glm::vec2 encodeOctahedral(glm::vec3 n) {
+    n /= (fabs(n.x) + fabs(n.y) + fabs(n.z));
+    glm::vec2 e(n.x, n.y);
+    if (n.z < 0.0f) {
+        e.x = (1.0f - fabs(n.y)) * (n.x >= 0.0f ? 1.0f : -1.0f);
+        e.y = (1.0f - fabs(n.x)) * (n.y >= 0.0f ? 1.0f : -1.0f);
+    }
+    return e;
+}
+
+glm::vec3 decodeOctahedral(glm::vec2 e) {
+    glm::vec3 n(e.x, e.y, 1.0f - fabs(e.x) - fabs(e.y));
+    float t = std::max(-n.z, 0.0f);
+    n.x += n.x >= 0.0f ? -t : t;
+    n.y += n.y >= 0.0f ? -t : t;
+    return glm::normalize(n);
+}
+
+// compresse les vertex et affiche l'erreur maximale par rapport aux floats d'origine
+std::vector<PackedVertex> quantizeVertices(const float* vertices, uint32_t vertexCount, const MeshFileHeader& header) {
+    glm::vec3 boundsMin(header.boundsMin[0], header.boundsMin[1], header.boundsMin[2]);
+    glm::vec3 boundsMax(header.boundsMax[0], header.boundsMax[1], header.boundsMax[2]);
+    glm::vec3 center = 0.5f * (boundsMin + boundsMax);
+    glm::vec3 extent = glm::max(0.5f * (boundsMax - boundsMin), glm::vec3(FLT_MIN));
+
+    std::vector<PackedVertex> packed(vertexCount);
+    float maxPositionError = 0.0f, maxNormalError = 0.0f, maxTexCoordError = 0.0f;
+
+    for (uint32_t i = 0; i < vertexCount; i++) {
+        const float* v = &vertices[i * FLOATS_PER_VERTEX];
+        glm::vec3 position(v[0], v[1], v[2]);
+        glm::vec3 normal = glm::normalize(glm::vec3(v[3], v[4], v[5]));
+        glm::vec2 texCoord(v[6], v[7]);
+
+        packed[i].position = glm::packSnorm4x16(glm::vec4((position - center) / extent, 0.0f));
+        packed[i].normal = glm::packSnorm2x16(encodeOctahedral(normal));
+        packed[i].texCoord = glm::packUnorm2x16(texCoord);
+
+        // decodage identique a celui du shader pour mesurer l'erreur
+        glm::vec3 decodedPosition = center + glm::vec3(glm::unpackSnorm4x16(packed[i].position)) * extent;
+        glm::vec3 decodedNormal = decodeOctahedral(glm::unpackSnorm2x16(packed[i].normal));
+        glm::vec2 decodedTexCoord = glm::unpackUnorm2x16(packed[i].texCoord);
+
+        float cosAngle = glm::clamp(glm::dot(normal, decodedNormal), -1.0f, 1.0f);
+        maxPositionError = std::max(maxPositionError, glm::length(decodedPosition - position));
+        maxNormalError = std::max(maxNormalError, glm::degrees(acosf(cosAngle)));
+        maxTexCoordError = std::max(maxTexCoordError, glm::length(decodedTexCoord - texCoord));
+    }
+
+    float diagonal = glm::length(boundsMax - boundsMin);
+    std::cout << "erreur max position : " << maxPositionError << " (" << 100.0f * maxPositionError / diagonal << " % de la diagonale)" << std::endl;
+    std::cout << "erreur max normale  : " << maxNormalError << " degres" << std::endl;
+    std::cout << "erreur max UV       : " << maxTexCoordError << std::endl;
+    return packed;
+}
+
+void printCacheStats(const char* label, const VertexCacheStats& stats) {
+    std::cout << label << "ACMR " << stats.acmr << ", ATVR " << stats.atvr << " (" << stats.misses << " vertex transformes)" << std::endl;
+}
+
+// ordre des triangles pour le cache post-transformation puis ordre des vertex pour le fetch
+void optimizeMesh(const char* name, void* vertices, uint32_t* indices, size_t indexCount, size_t vertexCount, size_t vertexStride) {
+    std::cout << name << " :" << std::endl;
+    printCacheStats("  avant : ", simulateVertexCache(indices, indexCount, vertexCount));
+
+    std::vector<uint32_t> source(indices, indices + indexCount);
+    optimizeVertexCache(indices, source.data(), indexCount, vertexCount);
+    optimizeVertexFetch(vertices, indices, indexCount, vertexCount, vertexStride);
+
+    printCacheStats("  apres : ", simulateVertexCache(indices, indexCount, vertexCount));
+}
+
+// decoupe le niveau 0 en clusters : les index sont reordonnes cluster par cluster, chaque cluster
+// garde sa sphere englobante et son cone de normales
+std::vector<MeshCluster> buildClusters(const float* vertices, std::vector<uint32_t>& indices, uint32_t vertexCount, bool optimize) {
+    const size_t vertexStride = FLOATS_PER_VERTEX * sizeof(float);
+    std::vector<Meshlet> meshlets(indices.size() / 3);
+    std::vector<uint32_t> source(indices);
+    meshlets.resize(buildMeshlets(meshlets.data(), indices.data(), source.data(), indices.size(), vertices, vertexCount, vertexStride));
+
+    std::vector<MeshCluster> clusters;
+    size_t cones = 0;
+    for (const Meshlet& meshlet : meshlets) {
+        uint32_t* clusterIndices = &indices[meshlet.indexOffset];
+        if (optimize) {
+            std::vector<uint32_t> clusterSource(clusterIndices, clusterIndices + meshlet.indexCount);
+            optimizeVertexCache(clusterIndices, clusterSource.data(), meshlet.indexCount, vertexCount);
+        }
+
+        MeshletBounds bounds = computeMeshletBounds(clusterIndices, meshlet.indexCount, vertices, vertexStride);
+        MeshCluster cluster = { meshlet.indexOffset, meshlet.indexCount,
+            { bounds.center[0], bounds.center[1], bounds.center[2] }, bounds.radius,
+            { bounds.coneApex[0], bounds.coneApex[1], bounds.coneApex[2] },
+            { bounds.coneAxis[0], bounds.coneAxis[1], bounds.coneAxis[2] }, bounds.coneCutoff, 0 };
+        clusters.push_back(cluster);
+        if (bounds.coneCutoff < 1.0f) cones++;
+    }
+
+    std::cout << "clusters : " << clusters.size() << " (" << (double)indices.size() / 3 / clusters.size() << " triangles en moyenne), "
+        << cones << " avec un cone de normales" << std::endl;
+    printCacheStats("  ordre par cluster : ", simulateVertexCache(indices.data(), indices.size(), vertexCount));
+    return clusters;
+}
+
+// fraction des triangles conservee par chaque niveau, le premier est le mesh d'origine
+const float LOD_RATIOS[] = { 1.0f, 0.5f, 0.25f, 0.1f, 0.03f };
+
+// chaine de LOD simplifiee depuis le niveau 0, index de tous les niveaux a la suite
+std::vector<uint32_t> buildLods(const float* vertices, const uint32_t* indices, uint32_t indexCount, uint32_t vertexCount, bool optimize,
+    float diagonal, std::vector<MeshLod>& lods) {
+    std::vector<uint32_t> allIndices(indices, indices + indexCount);
+    lods.push_back({ 0, indexCount, 0.0f, 0 });
+
+    std::vector<uint32_t> simplified(indexCount);
+    for (size_t level = 1; level < sizeof(LOD_RATIOS) / sizeof(LOD_RATIOS[0]); level++) {
+        size_t target = (size_t)(indexCount / 3 * LOD_RATIOS[level]) * 3;
+        float error = 0.0f;
+        size_t count = simplifyMesh(simplified.data(), indices, indexCount, vertices, vertexCount, FLOATS_PER_VERTEX * sizeof(float), target, &error, true);
+        if (count >= lods.back().indexCount) break;
+
+        if (optimize) {
+            std::vector<uint32_t> source(simplified.begin(), simplified.begin() + count);
+            optimizeVertexCache(simplified.data(), source.data(), count, vertexCount);
+        }
+        lods.push_back({ (uint32_t)allIndices.size(), (uint32_t)count, error, 0 });
+        allIndices.insert(allIndices.end(), simplified.begin(), simplified.begin() + count);
+    }
+
+    for (size_t level = 0; level < lods.size(); level++) {
+        std::cout << "LOD " << level << " : " << lods[level].indexCount / 3 << " triangles ("
+            << 100.0f * lods[level].indexCount / indexCount << " %), erreur " << lods[level].error
+            << " (" << 100.0f * lods[level].error / diagonal << " % de la diagonale)" << std::endl;
+    }
+    return allIndices;
+}
+
+int main(int argc, char** argv) {
+    bool quantize = false;
+    bool optimize = true;
+    const char* outputPath = nullptr;
+    for (int i = 1; i < argc; i++) {
+        if (strcmp(argv[i], "--quantize") == 0) quantize = true;
+        else if (strcmp(argv[i], "--no-optimize") == 0) optimize = false;
+        else if (strncmp(argv[i], "--", 2) != 0) outputPath = argv[i];
+        else {
+            std::cerr << "Option inconnue : " << argv[i] << std::endl;
+            std::cerr << "Usage : " << argv[0] << " [--quantize] [--no-optimize] [sortie.mesh]" << std::endl;
+            return 1;
+        }
+    }
+    if (!outputPath) outputPath = quantize ? "DragonPacked.mesh" : "Dragon.mesh";
+
+    const uint32_t vertexCount = sizeof(DragonVertices) / (FLOATS_PER_VERTEX * sizeof(float));
+    const uint32_t indexCount = sizeof(DragonIndices) / sizeof(uint16_t);
+
+    MeshFileHeader header = {};
+    header.vertexFormat = MESH_VERTEX_FLOAT8;
+    header.vertexStride = FLOATS_PER_VERTEX * sizeof(float);
+    header.vertexCount = vertexCount;
+    header.indexCount = indexCount;
+    header.indexSize = sizeof(uint16_t);
+
+    // boite englobante, utile pour la quantification et le culling
+    for (int axis = 0; axis < 3; axis++) {
+        header.boundsMin[axis] = FLT_MAX;
+        header.boundsMax[axis] = -FLT_MAX;
+    }
+    for (uint32_t i = 0; i < vertexCount; i++) {
+        const float* position = &DragonVertices[i * FLOATS_PER_VERTEX];
+        for (int axis = 0; axis < 3; axis++) {
+            if (position[axis] < header.boundsMin[axis]) header.boundsMin[axis] = position[axis];
+            if (position[axis] > header.boundsMax[axis]) header.boundsMax[axis] = position[axis];
+        }
+    }
+
+    std::vector<float> vertices(DragonVertices, DragonVertices + vertexCount * FLOATS_PER_VERTEX);
+    std::vector<uint32_t> indices(DragonIndices, DragonIndices + indexCount);
+
+    if (optimize) {
+        optimizeMesh("dragon", vertices.data(), indices.data(), indexCount, vertexCount, header.vertexStride);
+
+        // le cube n'est pas ecrit dans un fichier, on mesure seulement le gain
+        std::vector<float> cubeVertices(std::begin(cube_vertices), std::end(cube_vertices));
+        std::vector<uint32_t> cubeIndices(std::begin(cube_elements), std::end(cube_elements));
+        optimizeMesh("cube", cubeVertices.data(), cubeIndices.data(), cubeIndices.size(), cubeVertices.size() / 6, 6 * sizeof(float));
+    }
+
+    std::vector<MeshCluster> clusters = buildClusters(vertices.data(), indices, vertexCount, optimize);
+    header.clusterCount = (uint32_t)clusters.size();
+
+    float diagonal = 0.0f;
+    for (int axis = 0; axis < 3; axis++) diagonal += (header.boundsMax[axis] - header.boundsMin[axis]) * (header.boundsMax[axis] - header.boundsMin[axis]);
+
+    std::vector<MeshLod> lods;
+    std::vector<uint32_t> lodIndices = buildLods(vertices.data(), indices.data(), indexCount, vertexCount, optimize, sqrtf(diagonal), lods);
+    header.indexCount = (uint32_t)lodIndices.size();
+    header.lodCount = (uint32_t)lods.size();
+
+    std::vector<uint16_t> shortIndices(lodIndices.begin(), lodIndices.end());
+
+    const void* vertexData = vertices.data();
+    std::vector<PackedVertex> packed;
+    if (quantize) {
+        packed = quantizeVertices(vertices.data(), vertexCount, header);
+        header.vertexFormat = MESH_VERTEX_PACKED16;
+        header.vertexStride = sizeof(PackedVertex);
+        vertexData = packed.data();
+    }
+
+    if (!MeshFile::Write(outputPath, header, vertexData, shortIndices.data(), lods.data(), clusters.data())) return -1;
+
+    std::cout << outputPath << " : " << vertexCount << " vertices, " << indexCount / 3 << " triangles, " << header.lodCount << " LOD, " << header.clusterCount << " clusters, "
+        << header.vertexStride * vertexCount + header.indexSize * header.indexCount << " octets de donnees" << std::endl;
+    return 0;
+}
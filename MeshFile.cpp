@@ -0,0 +1,239 @@
+#include "MeshFile.h"
+#include <fstream>
+#include <iostream>
+#include <cstring>
+#include <algorithm>
+
+#ifdef _WIN32
+#define WIN32_LEAN_AND_MEAN
+#define NOMINMAX
+#include <windows.h>
+#else
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+#ifdef _WIN32
+MappedFile::MappedFile() : m_Data(nullptr), m_Size(0), m_File(INVALID_HANDLE_VALUE), m_Mapping(nullptr) {}
+#else
+MappedFile::MappedFile() : m_Data(nullptr), m_Size(0), m_File(-1) {}
+#endif
+
+MappedFile::~MappedFile() {
+    Close();
+}
+
+bool MappedFile::Open(const char* path) {
+    Close();
+#ifdef _WIN32
+    m_File = CreateFileA(path, GENERIC_READ, FILE_SHARE_READ, nullptr, OPEN_EXISTING, FILE_FLAG_SEQUENTIAL_SCAN, nullptr);
+    if (m_File == INVALID_HANDLE_VALUE) return false;
+
+    LARGE_INTEGER size;
+    if (!GetFileSizeEx(m_File, &size) || size.QuadPart == 0) {
+        Close();
+        return false;
+    }
+    m_Size = (size_t)size.QuadPart;
+
+    m_Mapping = CreateFileMappingA(m_File, nullptr, PAGE_READONLY, 0, 0, nullptr);
+    if (!m_Mapping) {
+        Close();
+        return false;
+    }
+    m_Data = static_cast<const uint8_t*>(MapViewOfFile(m_Mapping, FILE_MAP_READ, 0, 0, 0));
+#else
+    m_File = open(path, O_RDONLY);
+    if (m_File < 0) return false;
+
+    struct stat st;
+    if (fstat(m_File, &st) != 0 || st.st_size == 0) {
+        Close();
+        return false;
+    }
+    m_Size = (size_t)st.st_size;
+
+    void* data = mmap(nullptr, m_Size, PROT_READ, MAP_PRIVATE, m_File, 0);
+    if (data == MAP_FAILED) {
+        Close();
+        return false;
+    }
+    // le fichier est lu une seule fois en entier pour l'upload
+    madvise(data, m_Size, MADV_WILLNEED);
+    m_Data = static_cast<const uint8_t*>(data);
+#endif
+    if (!m_Data) {
+        Close();
+        return false;
+    }
+    return true;
+}
+
+void MappedFile::Close() {
+#ifdef _WIN32
+    if (m_Data) UnmapViewOfFile(m_Data);
+    if (m_Mapping) CloseHandle(m_Mapping);
+    if (m_File != INVALID_HANDLE_VALUE) CloseHandle(m_File);
+    m_Mapping = nullptr;
+    m_File = INVALID_HANDLE_VALUE;
+#else
+    if (m_Data) munmap(const_cast<uint8_t*>(m_Data), m_Size);
+    if (m_File >= 0) close(m_File);
+    m_File = -1;
+#endif
+    m_Data = nullptr;
+    m_Size = 0;
+}
+
+// taille d'un vertex pour chaque format, 0 si le format est inconnu
+static uint32_t VertexFormatStride(uint32_t format) {
+    switch (format) {
+    case MESH_VERTEX_FLOAT8: return 8 * sizeof(float);
+    case MESH_VERTEX_PACKED16: return 8 * sizeof(int16_t);
+    default: return 0;
+    }
+}
+
+// plus grand index du bloc, lu une fois pour que les utilisateurs puissent indexer les vertex sans controle
+static uint32_t MaxIndex(const void* indices, uint32_t indexCount, uint32_t indexSize) {
+    uint32_t maxIndex = 0;
+    if (indexSize == 2) {
+        const uint16_t* index16 = static_cast<const uint16_t*>(indices);
+        for (uint32_t i = 0; i < indexCount; i++) maxIndex = std::max<uint32_t>(maxIndex, index16[i]);
+    } else {
+        const uint32_t* index32 = static_cast<const uint32_t*>(indices);
+        for (uint32_t i = 0; i < indexCount; i++) maxIndex = std::max(maxIndex, index32[i]);
+    }
+    return maxIndex;
+}
+
+bool MeshFile::Open(const char* path) {
+    if (!m_File.Open(path)) {
+        std::cerr << "Failed to open mesh file: " << path << std::endl;
+        return false;
+    }
+
+    // l'en-tete a grandi en version 3 : copie de la partie presente, le reste a zero
+    m_Header = MeshFileHeader();
+    if (m_File.GetSize() >= MESH_FILE_HEADER_SIZE_V2) {
+        uint32_t version = reinterpret_cast<const MeshFileHeader*>(m_File.GetData())->version;
+        size_t headerSize = version >= 3 ? sizeof(MeshFileHeader) : MESH_FILE_HEADER_SIZE_V2;
+        if (m_File.GetSize() >= headerSize) memcpy(&m_Header, m_File.GetData(), headerSize);
+    }
+
+    const MeshFileHeader& header = GetHeader();
+    if (header.magic != MESH_FILE_MAGIC || header.version == 0 || header.version > MESH_FILE_VERSION ||
+        (header.version == 1 && header.lodCount != 0) || (header.indexSize != 2 && header.indexSize != 4) ||
+        VertexFormatStride(header.vertexFormat) == 0 || header.vertexStride != VertexFormatStride(header.vertexFormat)) {
+        std::cerr << "Invalid mesh file: " << path << std::endl;
+        Close();
+        return false;
+    }
+    if (header.vertexOffset > m_File.GetSize() || GetVertexBytes() > m_File.GetSize() - header.vertexOffset ||
+        header.indexOffset > m_File.GetSize() || GetIndexBytes() > m_File.GetSize() - header.indexOffset) {
+        std::cerr << "Truncated mesh file: " << path << std::endl;
+        Close();
+        return false;
+    }
+    if (header.lodCount) {
+        if (header.lodOffset + (uint64_t)header.lodCount * sizeof(MeshLod) > m_File.GetSize()) {
+            std::cerr << "Truncated mesh file: " << path << std::endl;
+            Close();
+            return false;
+        }
+        const MeshLod* lods = GetLods();
+        for (uint32_t i = 0; i < header.lodCount; i++) {
+            if ((uint64_t)lods[i].indexOffset + lods[i].indexCount > header.indexCount) {
+                std::cerr << "Invalid LOD table in mesh file: " << path << std::endl;
+                Close();
+                return false;
+            }
+        }
+    }
+    if (header.clusterCount) {
+        if (header.clusterOffset + (uint64_t)header.clusterCount * sizeof(MeshCluster) > m_File.GetSize()) {
+            std::cerr << "Truncated mesh file: " << path << std::endl;
+            Close();
+            return false;
+        }
+        const MeshCluster* clusters = GetClusters();
+        for (uint32_t i = 0; i < header.clusterCount; i++) {
+            if ((uint64_t)clusters[i].indexOffset + clusters[i].indexCount > header.indexCount) {
+                std::cerr << "Invalid cluster table in mesh file: " << path << std::endl;
+                Close();
+                return false;
+            }
+        }
+    }
+    if (header.indexCount && MaxIndex(GetIndices(), header.indexCount, header.indexSize) >= header.vertexCount) {
+        std::cerr << "Index out of range in mesh file: " << path << std::endl;
+        Close();
+        return false;
+    }
+    return true;
+}
+
+void MeshFile::DecodePosition(uint32_t vertex, float position[3]) const {
+    const MeshFileHeader& header = GetHeader();
+    const uint8_t* data = static_cast<const uint8_t*>(GetVertices()) + (size_t)vertex * header.vertexStride;
+    if (header.vertexFormat == MESH_VERTEX_PACKED16) {
+        int16_t packed[3];
+        memcpy(packed, data, sizeof(packed));
+        for (int axis = 0; axis < 3; axis++) {
+            float center = 0.5f * (header.boundsMin[axis] + header.boundsMax[axis]);
+            float extent = 0.5f * (header.boundsMax[axis] - header.boundsMin[axis]);
+            position[axis] = center + std::max(packed[axis] / 32767.0f, -1.0f) * extent;
+        }
+    } else {
+        memcpy(position, data, 3 * sizeof(float));
+    }
+}
+
+static uint64_t AlignOffset(uint64_t offset) {
+    return (offset + MESH_FILE_ALIGNMENT - 1) & ~(uint64_t)(MESH_FILE_ALIGNMENT - 1);
+}
+
+static void WritePadded(std::ofstream& file, const void* data, size_t size, uint64_t& offset) {
+    static const char zeros[MESH_FILE_ALIGNMENT] = {};
+    file.write(static_cast<const char*>(data), size);
+    offset += size;
+    size_t padding = (size_t)(AlignOffset(offset) - offset);
+    file.write(zeros, padding);
+    offset += padding;
+}
+
+bool MeshFile::Write(const char* path, MeshFileHeader header, const void* vertices, const void* indices, const MeshLod* lods,
+    const MeshCluster* clusters) {
+    if (!lods) header.lodCount = 0;
+    if (!clusters) header.clusterCount = 0;
+    header.magic = MESH_FILE_MAGIC;
+    header.version = MESH_FILE_VERSION;
+    uint64_t lodOffset = AlignOffset(sizeof(MeshFileHeader));
+    uint64_t clusterOffset = AlignOffset(lodOffset + (uint64_t)header.lodCount * sizeof(MeshLod));
+    header.lodOffset = header.lodCount ? lodOffset : 0;
+    header.clusterOffset = header.clusterCount ? clusterOffset : 0;
+    header.vertexOffset = AlignOffset(clusterOffset + (uint64_t)header.clusterCount * sizeof(MeshCluster));
+    header.indexOffset = AlignOffset(header.vertexOffset + (uint64_t)header.vertexCount * header.vertexStride);
+
+    std::ofstream file(path, std::ios::out | std::ios::binary | std::ios::trunc);
+    if (!file.is_open()) {
+        std::cerr << "Failed to create mesh file: " << path << std::endl;
+        return false;
+    }
+
+    uint64_t offset = 0;
+    WritePadded(file, &header, sizeof(header), offset);
+    if (header.lodCount) WritePadded(file, lods, header.lodCount * sizeof(MeshLod), offset);
+    if (header.clusterCount) WritePadded(file, clusters, header.clusterCount * sizeof(MeshCluster), offset);
+    WritePadded(file, vertices, (size_t)header.vertexCount * header.vertexStride, offset);
+    WritePadded(file, indices, (size_t)header.indexCount * header.indexSize, offset);
+    file.close();
+
+    if (file.fail()) {
+        std::cerr << "Failed to write mesh file: " << path << std::endl;
+        return false;
+    }
+    return true;
+}
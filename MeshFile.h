@@ -0,0 +1,118 @@
+#pragma once
+
+#include <cstdint>
+#include <cstddef>
+
+// format binaire d'un mesh : en-tete + table des LOD + table des clusters + bloc de vertex + bloc d'index,
+// blocs alignes sur 16 octets
+// les index de tous les LOD se suivent dans le bloc d'index et partagent le bloc de vertex ; les triangles
+// du niveau 0 sont ranges cluster par cluster
+// le fichier est mappe en memoire et envoye tel quel dans le VBO/EBO, sans etape de parsing
+
+const uint32_t MESH_FILE_MAGIC = 0x4853454D; // "MESH"
+const uint32_t MESH_FILE_VERSION = 3; // 1 : sans table des LOD, 2 : sans clusters
+const uint32_t MESH_FILE_ALIGNMENT = 16;
+
+enum MeshVertexFormat : uint32_t {
+    MESH_VERTEX_FLOAT8 = 0,   // X,Y,Z, NX,NY,NZ, U,V en float (32 octets)
+    MESH_VERTEX_PACKED16 = 1, // position snorm16 x4 relative a l'AABB, normale octaedrique snorm16 x2, UV unorm16 x2 (16 octets)
+};
+
+struct MeshFileHeader {
+    uint32_t magic;
+    uint32_t version;
+    uint32_t vertexFormat;
+    uint32_t vertexStride;   // en octets
+    uint32_t vertexCount;
+    uint32_t indexCount;     // tous LOD confondus
+    uint32_t indexSize;      // 2 (uint16_t) ou 4 (uint32_t)
+    uint32_t lodCount;       // 0 : un seul niveau couvrant tous les index (version 1)
+    uint64_t vertexOffset;   // depuis le debut du fichier
+    uint64_t indexOffset;
+    float boundsMin[3];
+    float boundsMax[3];
+    uint64_t lodOffset;
+    // version 3
+    uint32_t clusterCount;   // 0 : pas de culling par cluster
+    uint32_t padding;
+    uint64_t clusterOffset;
+};
+
+// taille de l'en-tete des versions 1 et 2, les champs suivants valent 0
+const size_t MESH_FILE_HEADER_SIZE_V2 = 80;
+
+// un niveau de detail : plage d'index et erreur geometrique introduite par la simplification
+struct MeshLod {
+    uint32_t indexOffset;    // en index, depuis le debut du bloc d'index
+    uint32_t indexCount;
+    float error;             // ecart maximal a la surface d'origine, en unites du mesh
+    uint32_t padding;
+};
+
+// cluster (meshlet) du niveau 0 : au plus 64 vertex et 124 triangles voisins, avec sa sphere englobante
+// et le cone de ses normales pour rejeter les clusters hors champ ou entierement de dos
+struct MeshCluster {
+    uint32_t indexOffset;    // en index, plage contigue du niveau 0
+    uint32_t indexCount;
+    float center[3];
+    float radius;
+    float coneApex[3];       // sommet du cone : de dos pour toute camera dans le cone oppose
+    float coneAxis[3];       // nul si les normales s'etalent sur plus d'un hemisphere
+    float coneCutoff;        // sinus du demi-angle du cone
+    uint32_t padding;
+};
+
+static_assert(sizeof(MeshFileHeader) % MESH_FILE_ALIGNMENT == 0, "MeshFileHeader doit rester aligne");
+static_assert(offsetof(MeshFileHeader, clusterCount) == MESH_FILE_HEADER_SIZE_V2, "les champs des versions 1 et 2 ne bougent pas");
+
+// fichier en lecture seule mappe en memoire (mmap / MapViewOfFile)
+class MappedFile {
+public:
+    MappedFile();
+    ~MappedFile();
+
+    MappedFile(const MappedFile&) = delete;
+    MappedFile& operator=(const MappedFile&) = delete;
+
+    bool Open(const char* path);
+    void Close();
+
+    const uint8_t* GetData() const { return m_Data; }
+    size_t GetSize() const { return m_Size; }
+
+private:
+    const uint8_t* m_Data;
+    size_t m_Size;
+#ifdef _WIN32
+    void* m_File;
+    void* m_Mapping;
+#else
+    int m_File;
+#endif
+};
+
+class MeshFile {
+public:
+    bool Open(const char* path);
+    void Close() { m_File.Close(); }
+
+    // copie completee par des zeros pour les en-tetes plus courts des anciennes versions
+    const MeshFileHeader& GetHeader() const { return m_Header; }
+    const void* GetVertices() const { return m_File.GetData() + GetHeader().vertexOffset; }
+    const void* GetIndices() const { return m_File.GetData() + GetHeader().indexOffset; }
+    size_t GetVertexBytes() const { return (size_t)GetHeader().vertexCount * GetHeader().vertexStride; }
+    size_t GetIndexBytes() const { return (size_t)GetHeader().indexCount * GetHeader().indexSize; }
+    // nullptr si le fichier n'a pas de table (lodCount == 0)
+    const MeshLod* GetLods() const { return GetHeader().lodCount ? reinterpret_cast<const MeshLod*>(m_File.GetData() + GetHeader().lodOffset) : nullptr; }
+    const MeshCluster* GetClusters() const { return GetHeader().clusterCount ? reinterpret_cast<const MeshCluster*>(m_File.GetData() + GetHeader().clusterOffset) : nullptr; }
+    // position d'un vertex en unites du mesh, decompressee comme dans Quantization.glsl pour MESH_VERTEX_PACKED16
+    void DecodePosition(uint32_t vertex, float position[3]) const;
+
+    // lods et clusters : header.lodCount et header.clusterCount entrees, ignores si nuls
+    static bool Write(const char* path, MeshFileHeader header, const void* vertices, const void* indices, const MeshLod* lods = nullptr,
+        const MeshCluster* clusters = nullptr);
+
+private:
+    MappedFile m_File;
+    MeshFileHeader m_Header;
+};
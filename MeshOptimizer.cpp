@@ -0,0 +1,666 @@
+#include "MeshOptimizer.h"
+#include <vector>
+#include <cmath>
+#include <cstring>
+#include <algorithm>
+#include <unordered_set>
+#include <cfloat>
+
+VertexCacheStats simulateVertexCache(const uint32_t* indices, size_t indexCount, size_t vertexCount, uint32_t cacheSize) {
+    // horodatage d'entree dans le FIFO : un vertex est present si il est entre il y a moins de cacheSize misses
+    std::vector<uint32_t> timestamps(vertexCount, 0);
+    std::vector<bool> used(vertexCount, false);
+    uint32_t time = cacheSize + 1;
+    uint32_t misses = 0;
+    size_t usedCount = 0;
+
+    for (size_t i = 0; i < indexCount; i++) {
+        uint32_t index = indices[i];
+        if (time - timestamps[index] > cacheSize) {
+            timestamps[index] = time++;
+            misses++;
+        }
+        if (!used[index]) {
+            used[index] = true;
+            usedCount++;
+        }
+    }
+
+    VertexCacheStats stats;
+    stats.misses = misses;
+    stats.acmr = indexCount ? (float)misses / (indexCount / 3) : 0.0f;
+    stats.atvr = usedCount ? (float)misses / usedCount : 0.0f;
+    return stats;
+}
+
+// parametres de l'article de Forsyth "Linear-Speed Vertex Cache Optimisation"
+const int FORSYTH_CACHE_SIZE = 32;
+const float FORSYTH_DECAY_POWER = 1.5f;
+const float FORSYTH_LAST_TRIANGLE_SCORE = 0.75f;
+const float FORSYTH_VALENCE_SCALE = 2.0f;
+const float FORSYTH_VALENCE_POWER = 0.5f;
+
+static float forsythVertexScore(int cachePosition, uint32_t remainingTriangles) {
+    if (remainingTriangles == 0) return -1.0f;
+
+    float score = 0.0f;
+    if (cachePosition >= 0) {
+        if (cachePosition < 3) {
+            // les vertex du dernier triangle ont un score fixe pour eviter de le repeter
+            score = FORSYTH_LAST_TRIANGLE_SCORE;
+        } else {
+            float scaler = 1.0f / (FORSYTH_CACHE_SIZE - 3);
+            score = powf(1.0f - (cachePosition - 3) * scaler, FORSYTH_DECAY_POWER);
+        }
+    }
+    // favorise les vertex avec peu de triangles restants pour ne pas laisser de triangles isoles
+    score += FORSYTH_VALENCE_SCALE * powf((float)remainingTriangles, -FORSYTH_VALENCE_POWER);
+    return score;
+}
+
+void optimizeVertexCache(uint32_t* destination, const uint32_t* indices, size_t indexCount, size_t vertexCount) {
+    size_t triangleCount = indexCount / 3;
+    if (triangleCount == 0) return;
+
+    // adjacence vertex -> triangles
+    std::vector<uint32_t> triangleCounts(vertexCount, 0);
+    for (size_t i = 0; i < indexCount; i++) triangleCounts[indices[i]]++;
+
+    std::vector<uint32_t> offsets(vertexCount + 1, 0);
+    for (size_t v = 0; v < vertexCount; v++) offsets[v + 1] = offsets[v] + triangleCounts[v];
+
+    std::vector<uint32_t> adjacency(indexCount);
+    std::vector<uint32_t> fill(offsets.begin(), offsets.end() - 1);
+    for (size_t t = 0; t < triangleCount; t++) {
+        for (int k = 0; k < 3; k++) adjacency[fill[indices[t * 3 + k]]++] = (uint32_t)t;
+    }
+
+    std::vector<uint32_t> remaining(triangleCounts);
+    std::vector<int> cachePositions(vertexCount, -1);
+    std::vector<float> vertexScores(vertexCount);
+    for (size_t v = 0; v < vertexCount; v++) vertexScores[v] = forsythVertexScore(-1, remaining[v]);
+
+    std::vector<float> triangleScores(triangleCount);
+    std::vector<bool> emitted(triangleCount, false);
+    for (size_t t = 0; t < triangleCount; t++) {
+        triangleScores[t] = vertexScores[indices[t * 3]] + vertexScores[indices[t * 3 + 1]] + vertexScores[indices[t * 3 + 2]];
+    }
+
+    uint32_t cache[FORSYTH_CACHE_SIZE + 3];
+    int cacheCount = 0;
+    size_t scanCursor = 0;
+
+    for (size_t emittedCount = 0; emittedCount < triangleCount; emittedCount++) {
+        // meilleur triangle parmi ceux qui touchent le cache, sinon premier triangle restant
+        int best = -1;
+        float bestScore = -1.0f;
+        for (int c = 0; c < cacheCount; c++) {
+            uint32_t v = cache[c];
+            for (uint32_t a = offsets[v]; a < offsets[v] + triangleCounts[v]; a++) {
+                uint32_t t = adjacency[a];
+                if (!emitted[t] && triangleScores[t] > bestScore) {
+                    bestScore = triangleScores[t];
+                    best = (int)t;
+                }
+            }
+        }
+        if (best < 0) {
+            while (emitted[scanCursor]) scanCursor++;
+            best = (int)scanCursor;
+        }
+
+        const uint32_t* triangle = &indices[best * 3];
+        emitted[best] = true;
+        memcpy(&destination[emittedCount * 3], triangle, 3 * sizeof(uint32_t));
+
+        // le triangle emis passe en tete du cache LRU
+        uint32_t newCache[FORSYTH_CACHE_SIZE + 3];
+        int newCount = 0;
+        for (int k = 0; k < 3; k++) newCache[newCount++] = triangle[k];
+        for (int c = 0; c < cacheCount; c++) {
+            uint32_t v = cache[c];
+            if (v != triangle[0] && v != triangle[1] && v != triangle[2]) newCache[newCount++] = v;
+        }
+
+        for (int k = 0; k < 3; k++) {
+            uint32_t v = triangle[k];
+            remaining[v]--;
+            // retire le triangle de la liste d'adjacence active du vertex
+            uint32_t begin = offsets[v], end = offsets[v] + triangleCounts[v];
+            for (uint32_t a = begin; a < end; a++) {
+                if (adjacency[a] == (uint32_t)best) {
+                    std::swap(adjacency[a], adjacency[end - 1]);
+                    triangleCounts[v]--;
+                    break;
+                }
+            }
+        }
+
+        // mise a jour des scores des vertex du cache et de ceux qui en sortent
+        for (int c = 0; c < newCount; c++) {
+            uint32_t v = newCache[c];
+            cachePositions[v] = c < FORSYTH_CACHE_SIZE ? c : -1;
+            float score = forsythVertexScore(cachePositions[v], remaining[v]);
+            float delta = score - vertexScores[v];
+            vertexScores[v] = score;
+            for (uint32_t a = offsets[v]; a < offsets[v] + triangleCounts[v]; a++) triangleScores[adjacency[a]] += delta;
+        }
+
+        cacheCount = std::min(newCount, FORSYTH_CACHE_SIZE);
+        memcpy(cache, newCache, cacheCount * sizeof(uint32_t));
+    }
+}
+
+size_t optimizeVertexFetch(void* vertices, uint32_t* indices, size_t indexCount, size_t vertexCount, size_t vertexStride) {
+    const uint32_t unused = ~0u;
+    std::vector<uint32_t> remap(vertexCount, unused);
+    uint32_t next = 0;
+    for (size_t i = 0; i < indexCount; i++) {
+        uint32_t& target = remap[indices[i]];
+        if (target == unused) target = next++;
+        indices[i] = target;
+    }
+    size_t usedCount = next;
+
+    // les vertex non references sont gardes a la fin
+    for (size_t v = 0; v < vertexCount; v++) {
+        if (remap[v] == unused) remap[v] = next++;
+    }
+
+    std::vector<uint8_t> source((uint8_t*)vertices, (uint8_t*)vertices + vertexCount * vertexStride);
+    for (size_t v = 0; v < vertexCount; v++) {
+        memcpy((uint8_t*)vertices + remap[v] * vertexStride, &source[v * vertexStride], vertexStride);
+    }
+    return usedCount;
+}
+
+// quadrique symetrique : erreur(p) = p.A.p + 2 b.p + c, somme des plans ponderes
+struct Quadric {
+    double a00, a01, a02, a11, a12, a22;
+    double b0, b1, b2;
+    double c;
+    double weight; // aire des triangles accumules, pour normaliser l'erreur
+};
+
+static void addPlaneQuadric(Quadric& q, const double n[3], double d, double weight) {
+    q.a00 += weight * n[0] * n[0];
+    q.a01 += weight * n[0] * n[1];
+    q.a02 += weight * n[0] * n[2];
+    q.a11 += weight * n[1] * n[1];
+    q.a12 += weight * n[1] * n[2];
+    q.a22 += weight * n[2] * n[2];
+    q.b0 += weight * n[0] * d;
+    q.b1 += weight * n[1] * d;
+    q.b2 += weight * n[2] * d;
+    q.c += weight * d * d;
+}
+
+static void addQuadric(Quadric& q, const Quadric& r) {
+    q.a00 += r.a00; q.a01 += r.a01; q.a02 += r.a02;
+    q.a11 += r.a11; q.a12 += r.a12; q.a22 += r.a22;
+    q.b0 += r.b0; q.b1 += r.b1; q.b2 += r.b2;
+    q.c += r.c;
+    q.weight += r.weight;
+}
+
+// distance quadratique moyenne aux plans accumules
+static double evaluateQuadric(const Quadric& q, const float* p) {
+    double x = p[0], y = p[1], z = p[2];
+    double e = q.a00 * x * x + q.a11 * y * y + q.a22 * z * z + 2.0 * (q.a01 * x * y + q.a02 * x * z + q.a12 * y * z)
+        + 2.0 * (q.b0 * x + q.b1 * y + q.b2 * z) + q.c;
+    return q.weight > 0.0 ? fabs(e) / q.weight : fabs(e);
+}
+
+static void triangleNormal(const float* p0, const float* p1, const float* p2, double n[3]) {
+    double e1[3] = { (double)p1[0] - p0[0], (double)p1[1] - p0[1], (double)p1[2] - p0[2] };
+    double e2[3] = { (double)p2[0] - p0[0], (double)p2[1] - p0[1], (double)p2[2] - p0[2] };
+    n[0] = e1[1] * e2[2] - e1[2] * e2[1];
+    n[1] = e1[2] * e2[0] - e1[0] * e2[2];
+    n[2] = e1[0] * e2[1] - e1[1] * e2[0];
+}
+
+// vertex de meme position (comparaison bit a bit) : remap vers un representant commun
+static std::vector<uint32_t> buildPositionRemap(const void* vertices, size_t vertexCount, size_t vertexStride) {
+    auto position = [&](uint32_t v) {
+        return reinterpret_cast<const float*>(static_cast<const uint8_t*>(vertices) + v * vertexStride);
+    };
+    std::vector<uint32_t> order(vertexCount), remap(vertexCount);
+    for (size_t v = 0; v < vertexCount; v++) order[v] = (uint32_t)v;
+    std::sort(order.begin(), order.end(), [&](uint32_t a, uint32_t b) {
+        int c = memcmp(position(a), position(b), 3 * sizeof(float));
+        return c < 0 || (c == 0 && a < b);
+    });
+    for (size_t i = 0; i < vertexCount; i++) {
+        uint32_t v = order[i];
+        bool same = i > 0 && memcmp(position(order[i - 1]), position(v), 3 * sizeof(float)) == 0;
+        remap[v] = same ? remap[order[i - 1]] : v;
+    }
+    return remap;
+}
+
+static uint64_t edgeKey(uint32_t a, uint32_t b) {
+    return ((uint64_t)a << 32) | b;
+}
+
+enum SimplifyVertexKind : uint8_t {
+    SIMPLIFY_MANIFOLD, // interieur, une seule normale/UV : se contracte vers n'importe quel voisin
+    SIMPLIFY_SEAM,     // deux jumeaux sur une couture simple : se contracte le long de la couture
+    SIMPLIFY_COMPLEX,  // extremite ou croisement de coutures : fixe, sauf en mode permissif
+    SIMPLIFY_LOCKED,   // bord ouvert du maillage
+};
+
+struct SimplifyCollapse {
+    uint32_t vertex;
+    uint32_t target;
+    double error;
+};
+
+// ecart de la contraction au-dela duquel un triangle est considere comme retourne (cosinus entre normales)
+const double SIMPLIFY_FLIP_COSINE = 0.05;
+
+size_t simplifyMesh(uint32_t* destination, const uint32_t* indices, size_t indexCount, const void* vertices, size_t vertexCount, size_t vertexStride,
+    size_t targetIndexCount, float* error, bool permissive) {
+    auto position = [&](uint32_t v) {
+        return reinterpret_cast<const float*>(static_cast<const uint8_t*>(vertices) + v * vertexStride);
+    };
+
+    std::vector<uint32_t> remap = buildPositionRemap(vertices, vertexCount, vertexStride);
+
+    std::vector<uint32_t> result(indices, indices + indexCount);
+    std::unordered_set<uint64_t> edges, positionEdges;
+    std::vector<uint32_t> openOut(vertexCount), openIn(vertexCount), openOutCount(vertexCount), openInCount(vertexCount);
+    std::vector<uint8_t> borders(vertexCount);
+
+    // aretes orientees presentes ; sans jumelle inverse, ce sont des coutures (vertex) ou des bords (positions)
+    auto buildEdges = [&]() {
+        edges.clear();
+        positionEdges.clear();
+        edges.reserve(result.size() * 2);
+        positionEdges.reserve(result.size() * 2);
+        for (size_t i = 0; i < result.size(); i += 3) {
+            for (int k = 0; k < 3; k++) {
+                uint32_t a = result[i + k], b = result[i + (k + 1) % 3];
+                edges.insert(edgeKey(a, b));
+                positionEdges.insert(edgeKey(remap[a], remap[b]));
+            }
+        }
+        std::fill(openOutCount.begin(), openOutCount.end(), 0);
+        std::fill(openInCount.begin(), openInCount.end(), 0);
+        std::fill(borders.begin(), borders.end(), 0);
+        for (size_t i = 0; i < result.size(); i += 3) {
+            for (int k = 0; k < 3; k++) {
+                uint32_t a = result[i + k], b = result[i + (k + 1) % 3];
+                if (!positionEdges.count(edgeKey(remap[b], remap[a]))) borders[remap[a]] = borders[remap[b]] = 1;
+                if (edges.count(edgeKey(b, a))) continue;
+                openOut[a] = b;
+                openOutCount[a]++;
+                openIn[b] = a;
+                openInCount[b]++;
+            }
+        }
+    };
+
+    // quadriques par position : plans des triangles ponderes par l'aire
+    // les bords sont fixes et les coutures ne glissent que sur elles-memes, inutile de les retenir par des plans
+    std::vector<Quadric> quadrics(vertexCount, Quadric{});
+    for (size_t i = 0; i < result.size(); i += 3) {
+        const float* p[3] = { position(result[i]), position(result[i + 1]), position(result[i + 2]) };
+        double n[3];
+        triangleNormal(p[0], p[1], p[2], n);
+        double length = sqrt(n[0] * n[0] + n[1] * n[1] + n[2] * n[2]);
+        if (length == 0.0) continue;
+        for (int axis = 0; axis < 3; axis++) n[axis] /= length;
+        double d = -(n[0] * p[0][0] + n[1] * p[0][1] + n[2] * p[0][2]);
+        double area = 0.5 * length;
+
+        for (int k = 0; k < 3; k++) {
+            Quadric& q = quadrics[remap[result[i + k]]];
+            addPlaneQuadric(q, n, d, area);
+            q.weight += area;
+        }
+    }
+
+    const uint32_t none = ~0u;
+    std::vector<uint8_t> kinds(vertexCount), touched(vertexCount);
+    std::vector<uint32_t> groupFirst(vertexCount), groupNext(vertexCount), collapseTarget(vertexCount);
+    std::vector<uint32_t> triangleOffsets(vertexCount + 1), triangleList;
+    std::vector<SimplifyCollapse> best(vertexCount), collapses;
+    double maxError = 0.0;
+    bool crossSeams = false;
+
+    // passes : meilleure contraction par position, triees par erreur, appliquees sans voisinage commun
+    while (result.size() > targetIndexCount) {
+        buildEdges();
+
+        // jumeaux : vertex utilises partageant une position, chaines par groupNext
+        std::fill(groupFirst.begin(), groupFirst.end(), none);
+        std::fill(touched.begin(), touched.end(), 0);
+        for (uint32_t v : result) {
+            if (touched[v]) continue;
+            touched[v] = 1;
+            groupNext[v] = groupFirst[remap[v]];
+            groupFirst[remap[v]] = v;
+        }
+
+        for (uint32_t v : result) {
+            uint32_t first = groupFirst[remap[v]];
+            uint32_t twin = first == v ? groupNext[v] : first;
+            if (borders[remap[v]]) {
+                kinds[v] = SIMPLIFY_LOCKED;
+            } else if (twin == none) {
+                kinds[v] = openOutCount[v] || openInCount[v] ? SIMPLIFY_COMPLEX : SIMPLIFY_MANIFOLD;
+            } else if (groupNext[groupNext[first]] == none) {
+                bool seam = openOutCount[v] == 1 && openInCount[v] == 1 && openOutCount[twin] == 1 && openInCount[twin] == 1 &&
+                    remap[openOut[v]] == remap[openIn[twin]] && remap[openIn[v]] == remap[openOut[twin]];
+                kinds[v] = seam ? SIMPLIFY_SEAM : SIMPLIFY_COMPLEX;
+            } else {
+                kinds[v] = SIMPLIFY_COMPLEX;
+            }
+        }
+
+        // triangles autour de chaque position
+        std::fill(triangleOffsets.begin(), triangleOffsets.end(), 0);
+        for (uint32_t v : result) triangleOffsets[remap[v] + 1]++;
+        for (size_t v = 0; v < vertexCount; v++) triangleOffsets[v + 1] += triangleOffsets[v];
+        triangleList.resize(result.size());
+        for (size_t i = 0; i < result.size(); i++) triangleList[triangleOffsets[remap[result[i]]]++] = (uint32_t)(i / 3);
+        for (size_t v = vertexCount; v > 0; v--) triangleOffsets[v] = triangleOffsets[v - 1];
+        triangleOffsets[0] = 0;
+
+        // contraction de v sur la position de t, gardee si c'est la moins chere pour cette position
+        auto consider = [&](uint32_t v, uint32_t t) {
+            if (kinds[v] == SIMPLIFY_LOCKED || remap[v] == remap[t]) return;
+            if (kinds[v] == SIMPLIFY_COMPLEX && !crossSeams) return;
+            if (kinds[v] == SIMPLIFY_SEAM && !crossSeams) {
+                bool seamEdge = openOut[v] == t || openIn[v] == t;
+                if (!seamEdge || kinds[t] == SIMPLIFY_MANIFOLD) return;
+            }
+            Quadric q = quadrics[remap[v]];
+            addQuadric(q, quadrics[remap[t]]);
+            double e = evaluateQuadric(q, position(t));
+            SimplifyCollapse& candidate = best[remap[v]];
+            if (candidate.vertex == none || e < candidate.error) candidate = { v, t, e };
+        };
+        for (uint32_t v : result) best[remap[v]].vertex = none;
+        for (size_t i = 0; i < result.size(); i += 3) {
+            for (int k = 0; k < 3; k++) {
+                uint32_t a = result[i + k], b = result[i + (k + 1) % 3];
+                consider(a, b);
+                consider(b, a);
+            }
+        }
+
+        collapses.clear();
+        for (size_t i = 0; i < result.size(); i++) {
+            uint32_t leader = remap[result[i]];
+            if (best[leader].vertex != none) {
+                collapses.push_back(best[leader]);
+                best[leader].vertex = none;
+            }
+        }
+        std::sort(collapses.begin(), collapses.end(), [](const SimplifyCollapse& a, const SimplifyCollapse& b) { return a.error < b.error; });
+
+        // une contraction retire environ deux triangles
+        size_t trianglesToRemove = (result.size() - targetIndexCount + 2) / 3;
+        size_t removed = 0;
+        std::fill(touched.begin(), touched.end(), 0);
+        for (uint32_t v : result) collapseTarget[v] = v;
+
+        for (const SimplifyCollapse& collapse : collapses) {
+            if (removed >= trianglesToRemove) break;
+            uint32_t v = collapse.vertex, t = collapse.target;
+            uint32_t lv = remap[v], lt = remap[t];
+            if (touched[lv] || touched[lt]) continue;
+
+            // les triangles restants autour de la position ne doivent pas se retourner
+            const float* target = position(t);
+            bool flipped = false;
+            for (uint32_t a = triangleOffsets[lv]; a < triangleOffsets[lv + 1] && !flipped; a++) {
+                const uint32_t* triangle = &result[triangleList[a] * 3];
+                if (remap[triangle[0]] == lt || remap[triangle[1]] == lt || remap[triangle[2]] == lt) continue;
+                const float* before[3], * after[3];
+                for (int k = 0; k < 3; k++) {
+                    before[k] = position(triangle[k]);
+                    after[k] = remap[triangle[k]] == lv ? target : before[k];
+                }
+                double n0[3], n1[3];
+                triangleNormal(before[0], before[1], before[2], n0);
+                triangleNormal(after[0], after[1], after[2], n1);
+                double dot = n0[0] * n1[0] + n0[1] * n1[1] + n0[2] * n1[2];
+                double lengths = sqrt((n0[0] * n0[0] + n0[1] * n0[1] + n0[2] * n0[2]) * (n1[0] * n1[0] + n1[1] * n1[1] + n1[2] * n1[2]));
+                flipped = dot <= SIMPLIFY_FLIP_COSINE * lengths;
+            }
+            if (flipped) continue;
+
+            // chaque jumeau suit le vertex de la position cible qu'il partage avec un triangle de l'arete,
+            // a defaut (couture franchie en mode permissif) celui de la contraction
+            for (uint32_t w = groupFirst[lv]; w != none; w = groupNext[w]) {
+                collapseTarget[w] = t;
+                for (uint32_t a = triangleOffsets[lv]; a < triangleOffsets[lv + 1]; a++) {
+                    const uint32_t* triangle = &result[triangleList[a] * 3];
+                    if (triangle[0] != w && triangle[1] != w && triangle[2] != w) continue;
+                    for (int k = 0; k < 3; k++) {
+                        if (remap[triangle[k]] == lt) collapseTarget[w] = triangle[k];
+                    }
+                }
+            }
+            addQuadric(quadrics[lt], quadrics[lv]);
+            maxError = std::max(maxError, collapse.error);
+
+            // le voisinage est fige jusqu'a la passe suivante, ses triangles ont change
+            for (uint32_t a = triangleOffsets[lv]; a < triangleOffsets[lv + 1]; a++) {
+                const uint32_t* triangle = &result[triangleList[a] * 3];
+                for (int k = 0; k < 3; k++) touched[remap[triangle[k]]] = 1;
+            }
+            removed += 2;
+        }
+        if (removed == 0) {
+            // plus rien a contracter sans franchir de couture
+            if (!permissive || crossSeams) break;
+            crossSeams = true;
+            continue;
+        }
+
+        // reecriture des index, les triangles degeneres en position disparaissent
+        size_t write = 0;
+        for (size_t i = 0; i < result.size(); i += 3) {
+            uint32_t a = collapseTarget[result[i]], b = collapseTarget[result[i + 1]], c = collapseTarget[result[i + 2]];
+            if (remap[a] == remap[b] || remap[b] == remap[c] || remap[c] == remap[a]) continue;
+            result[write++] = a;
+            result[write++] = b;
+            result[write++] = c;
+        }
+        result.resize(write);
+    }
+
+    memcpy(destination, result.data(), result.size() * sizeof(uint32_t));
+    if (error) *error = (float)sqrt(maxError);
+    return result.size();
+}
+
+// normale unitaire d'un triangle, nulle s'il est degenere
+static void unitTriangleNormal(const float* p0, const float* p1, const float* p2, float normal[3]) {
+    double n[3];
+    triangleNormal(p0, p1, p2, n);
+    double length = sqrt(n[0] * n[0] + n[1] * n[1] + n[2] * n[2]);
+    for (int axis = 0; axis < 3; axis++) normal[axis] = length > 0.0 ? (float)(n[axis] / length) : 0.0f;
+}
+
+// poids de l'ecart a l'axe du cone face au nombre de vertex ajoutes, dans le choix du triangle suivant
+const float MESHLET_CONE_WEIGHT = 1.0f;
+// pas de l'approximation de la plus petite boule englobant les normales
+const int MESHLET_CONE_ITERATIONS = 64;
+
+size_t buildMeshlets(Meshlet* meshlets, uint32_t* destination, const uint32_t* indices, size_t indexCount, const void* vertices,
+    size_t vertexCount, size_t vertexStride) {
+    auto position = [&](uint32_t v) {
+        return reinterpret_cast<const float*>(static_cast<const uint8_t*>(vertices) + v * vertexStride);
+    };
+    const uint32_t none = ~0u;
+    size_t triangleCount = indexCount / 3;
+
+    std::vector<float> normals(triangleCount * 3);
+    for (size_t t = 0; t < triangleCount; t++) {
+        unitTriangleNormal(position(indices[t * 3]), position(indices[t * 3 + 1]), position(indices[t * 3 + 2]), &normals[t * 3]);
+    }
+
+    // triangles autour de chaque position : les voisins de l'autre cote d'une couture UV en font partie
+    std::vector<uint32_t> remap = buildPositionRemap(vertices, vertexCount, vertexStride);
+    std::vector<uint32_t> offsets(vertexCount + 1, 0), adjacency(indexCount);
+    for (size_t i = 0; i < indexCount; i++) offsets[remap[indices[i]] + 1]++;
+    for (size_t v = 0; v < vertexCount; v++) offsets[v + 1] += offsets[v];
+    for (size_t i = 0; i < indexCount; i++) adjacency[offsets[remap[indices[i]]]++] = (uint32_t)(i / 3);
+    for (size_t v = vertexCount; v > 0; v--) offsets[v] = offsets[v - 1];
+    offsets[0] = 0;
+
+    std::vector<bool> emitted(triangleCount, false);
+    std::vector<uint32_t> owner(vertexCount, none);   // dernier meshlet ayant utilise le vertex
+    std::vector<uint32_t> meshletVertices;
+    meshletVertices.reserve(MESHLET_MAX_VERTICES);
+
+    size_t meshletCount = 0, written = 0, seed = 0;
+    while (written < triangleCount * 3) {
+        // chaque meshlet part du premier triangle restant dans l'ordre d'entree
+        while (emitted[seed]) seed++;
+        Meshlet& meshlet = meshlets[meshletCount];
+        meshlet.indexOffset = (uint32_t)written;
+        meshlet.indexCount = 0;
+        meshletVertices.clear();
+        float cone[3] = { 0.0f, 0.0f, 0.0f };
+
+        uint32_t triangle = (uint32_t)seed;
+        while (triangle != none) {
+            emitted[triangle] = true;
+            for (int k = 0; k < 3; k++) {
+                uint32_t v = indices[triangle * 3 + k];
+                destination[written++] = v;
+                if (owner[v] != meshletCount) {
+                    owner[v] = (uint32_t)meshletCount;
+                    meshletVertices.push_back(v);
+                }
+            }
+            for (int axis = 0; axis < 3; axis++) cone[axis] += normals[triangle * 3 + axis];
+            meshlet.indexCount += 3;
+            if (meshlet.indexCount == MESHLET_MAX_TRIANGLES * 3) break;
+
+            // triangle voisin qui ajoute le moins de vertex et s'ecarte le moins de la normale moyenne
+            float length = sqrtf(cone[0] * cone[0] + cone[1] * cone[1] + cone[2] * cone[2]);
+            float axis[3] = { 0.0f, 0.0f, 0.0f };
+            if (length > 0.0f) for (int k = 0; k < 3; k++) axis[k] = cone[k] / length;
+
+            triangle = none;
+            float bestScore = FLT_MAX;
+            for (uint32_t v : meshletVertices) {
+                for (uint32_t a = offsets[remap[v]]; a < offsets[remap[v] + 1]; a++) {
+                    uint32_t candidate = adjacency[a];
+                    if (emitted[candidate]) continue;
+                    size_t extra = 0;
+                    for (int k = 0; k < 3; k++) extra += owner[indices[candidate * 3 + k]] != meshletCount;
+                    if (meshletVertices.size() + extra > MESHLET_MAX_VERTICES) continue;
+
+                    const float* n = &normals[candidate * 3];
+                    float score = extra + MESHLET_CONE_WEIGHT * (1.0f - (n[0] * axis[0] + n[1] * axis[1] + n[2] * axis[2]));
+                    if (score < bestScore) {
+                        bestScore = score;
+                        triangle = candidate;
+                    }
+                }
+            }
+        }
+        meshletCount++;
+    }
+    return meshletCount;
+}
+
+MeshletBounds computeMeshletBounds(const uint32_t* indices, size_t indexCount, const void* vertices, size_t vertexStride) {
+    auto position = [&](uint32_t v) {
+        return reinterpret_cast<const float*>(static_cast<const uint8_t*>(vertices) + v * vertexStride);
+    };
+    MeshletBounds bounds = {};
+
+    // sphere centree sur l'AABB, rayon au coin le plus eloigne
+    float boundsMin[3] = { FLT_MAX, FLT_MAX, FLT_MAX };
+    float boundsMax[3] = { -FLT_MAX, -FLT_MAX, -FLT_MAX };
+    for (size_t i = 0; i < indexCount; i++) {
+        const float* p = position(indices[i]);
+        for (int axis = 0; axis < 3; axis++) {
+            boundsMin[axis] = std::min(boundsMin[axis], p[axis]);
+            boundsMax[axis] = std::max(boundsMax[axis], p[axis]);
+        }
+    }
+    for (int axis = 0; axis < 3; axis++) bounds.center[axis] = 0.5f * (boundsMin[axis] + boundsMax[axis]);
+    float radiusSquared = 0.0f;
+    for (size_t i = 0; i < indexCount; i++) {
+        const float* p = position(indices[i]);
+        float dx = p[0] - bounds.center[0], dy = p[1] - bounds.center[1], dz = p[2] - bounds.center[2];
+        radiusSquared = std::max(radiusSquared, dx * dx + dy * dy + dz * dz);
+    }
+    bounds.radius = sqrtf(radiusSquared);
+
+    // normales unitaires, les triangles degeneres n'ont pas d'orientation et ne limitent pas le cone
+    std::vector<float> normals;
+    std::vector<const float*> corners;
+    for (size_t i = 0; i < indexCount; i += 3) {
+        float n[3];
+        unitTriangleNormal(position(indices[i]), position(indices[i + 1]), position(indices[i + 2]), n);
+        if (n[0] == 0.0f && n[1] == 0.0f && n[2] == 0.0f) continue;
+        normals.insert(normals.end(), n, n + 3);
+        corners.push_back(position(indices[i]));
+    }
+    size_t normalCount = corners.size();
+    if (!normalCount) {
+        bounds.coneCutoff = 1.0f;
+        return bounds;
+    }
+
+    // axe : centre de la plus petite boule englobant les extremites des normales (approximation de
+    // Badoiu-Clarkson, pas de 1 / (k + 1) vers la normale la plus eloignee), plus serre que la moyenne
+    float axis[3] = { normals[0], normals[1], normals[2] };
+    for (int step = 1; step <= MESHLET_CONE_ITERATIONS; step++) {
+        size_t farthest = 0;
+        float farthestDistance = -1.0f;
+        for (size_t i = 0; i < normalCount; i++) {
+            const float* n = &normals[i * 3];
+            float dx = n[0] - axis[0], dy = n[1] - axis[1], dz = n[2] - axis[2];
+            float distance = dx * dx + dy * dy + dz * dz;
+            if (distance > farthestDistance) {
+                farthestDistance = distance;
+                farthest = i;
+            }
+        }
+        for (int k = 0; k < 3; k++) axis[k] += (normals[farthest * 3 + k] - axis[k]) / (step + 1);
+    }
+    float length = sqrtf(axis[0] * axis[0] + axis[1] * axis[1] + axis[2] * axis[2]);
+    if (length == 0.0f) {
+        bounds.coneCutoff = 1.0f;
+        return bounds;
+    }
+    for (int k = 0; k < 3; k++) axis[k] /= length;
+
+    // demi-angle : normale la plus ecartee de l'axe
+    float minDot = 1.0f;
+    for (size_t i = 0; i < normalCount; i++) {
+        const float* n = &normals[i * 3];
+        minDot = std::min(minDot, n[0] * axis[0] + n[1] * axis[1] + n[2] * axis[2]);
+    }
+    if (minDot <= 0.0f) {
+        // cone plus large qu'un hemisphere : axe nul, jamais rejete
+        bounds.coneCutoff = 1.0f;
+        return bounds;
+    }
+
+    // sommet : on recule depuis le centre le long de l'axe jusqu'a passer derriere le plan de chaque triangle
+    float apexDistance = 0.0f;
+    for (size_t i = 0; i < normalCount; i++) {
+        const float* n = &normals[i * 3];
+        const float* p = corners[i];
+        float planeDistance = (bounds.center[0] - p[0]) * n[0] + (bounds.center[1] - p[1]) * n[1] + (bounds.center[2] - p[2]) * n[2];
+        apexDistance = std::max(apexDistance, planeDistance / (n[0] * axis[0] + n[1] * axis[1] + n[2] * axis[2]));
+    }
+    for (int k = 0; k < 3; k++) {
+        bounds.coneApex[k] = bounds.center[k] - axis[k] * apexDistance;
+        bounds.coneAxis[k] = axis[k];
+    }
+    bounds.coneCutoff = sqrtf(std::max(0.0f, 1.0f - minDot * minDot));
+    return bounds;
+}
@@ -0,0 +1,59 @@
+#pragma once
+
+#include <cstdint>
+#include <cstddef>
+
+// statistiques du cache post-transformation simule (FIFO)
+struct VertexCacheStats {
+    uint32_t misses;   // vertex transformes
+    float acmr;        // vertex transformes par triangle (1.0 = optimal pour un maillage regulier, 3.0 = pire cas)
+    float atvr;        // vertex transformes par vertex utilise (1.0 = optimal)
+};
+
+// simulateur logiciel de cache de vertex, pour mesurer le gain sans GPU
+VertexCacheStats simulateVertexCache(const uint32_t* indices, size_t indexCount, size_t vertexCount, uint32_t cacheSize = 16);
+
+// reordonne les triangles pour la localite du cache post-transformation (algorithme de Tom Forsyth)
+void optimizeVertexCache(uint32_t* destination, const uint32_t* indices, size_t indexCount, size_t vertexCount);
+
+// reordonne les vertex dans l'ordre de premiere utilisation et reecrit les index en consequence
+// retourne le nombre de vertex references par les index
+size_t optimizeVertexFetch(void* vertices, uint32_t* indices, size_t indexCount, size_t vertexCount, size_t vertexStride);
+
+// simplification par contraction d'aretes guidee par les quadriques d'erreur (Garland et Heckbert)
+// positions : 3 floats en tete de chaque vertex, vertexStride en octets ; les vertex ne sont pas modifies
+// les vertex d'une meme position avec normale ou UV differentes (couture) ne glissent que le long de la couture,
+// les bords ouverts et les extremites ou croisements de coutures restent fixes
+// permissive : quand plus rien ne se contracte, les coutures sont franchies (UV etirees, reserve aux LOD lointains)
+// destination recoit au plus indexCount index ; retourne leur nombre (peut rester au-dessus de la cible si le mesh est bloque)
+// error recoit l'ecart maximal introduit, en unites du mesh
+size_t simplifyMesh(uint32_t* destination, const uint32_t* indices, size_t indexCount, const void* vertices, size_t vertexCount, size_t vertexStride,
+    size_t targetIndexCount, float* error, bool permissive = false);
+
+const size_t MESHLET_MAX_VERTICES = 64;
+const size_t MESHLET_MAX_TRIANGLES = 124;
+
+// plage de triangles d'un meshlet dans les index reordonnes
+struct Meshlet {
+    uint32_t indexOffset;
+    uint32_t indexCount;
+};
+
+// sphere englobante et cone des normales d'un meshlet
+// le meshlet est entierement de dos si dot(coneAxis, coneApex - camera) >= coneCutoff * |coneApex - camera|
+struct MeshletBounds {
+    float center[3];
+    float radius;
+    float coneApex[3];   // point de l'axe derriere tous les plans des triangles
+    float coneAxis[3];   // nul si les normales s'etalent sur plus d'un hemisphere (jamais de dos)
+    float coneCutoff;    // sinus du demi-angle du cone
+};
+
+// regroupe les triangles voisins et d'orientation proche en meshlets d'au plus MESHLET_MAX_VERTICES vertex
+// et MESHLET_MAX_TRIANGLES triangles, en partant de l'ordre des index (ordre du cache)
+// destination recoit les index reordonnes, meshlets contigus ; meshlets doit pouvoir contenir indexCount / 3 entrees
+// retourne le nombre de meshlets
+size_t buildMeshlets(Meshlet* meshlets, uint32_t* destination, const uint32_t* indices, size_t indexCount, const void* vertices,
+    size_t vertexCount, size_t vertexStride);
+
+MeshletBounds computeMeshletBounds(const uint32_t* indices, size_t indexCount, const void* vertices, size_t vertexStride);
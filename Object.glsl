@@ -0,0 +1,10 @@
+// matrice model : bloc Object par draw, ou attribut par instance avec INSTANCED
+#ifdef INSTANCED
+// 4 locations consecutives (3 a 6), diviseur 1
+layout(location = 3) in mat4 instanceModel;
+#define model instanceModel
+#else
+layout(std140) uniform Object {
+    mat4 model;
+};
+#endif
@@ -0,0 +1,342 @@
+#include "OcclusionCulling.h"
+#include "Profiler.h"
+#include <algorithm>
+#include <cmath>
+#include <map>
+#include <tuple>
+
+#if defined(MATH_SIMD_SSE)
+#include <immintrin.h>
+#elif defined(MATH_SIMD_NEON)
+#include <arm_neon.h>
+#endif
+
+static const size_t OCCLUDER_JOB_GRAIN = 8;
+static const size_t OCCLUSION_TEST_GRAIN = 256;
+// en deca, le sommet est trop proche de la camera pour etre projete
+static const float OCCLUSION_MIN_W = 1e-4f;
+
+OcclusionBuffer::OcclusionBuffer() : m_Width(0), m_Height(0), m_TilesX(0), m_TilesY(0), m_ViewProjection(identityMatrix()) {}
+
+void OcclusionBuffer::Create(uint32_t screenWidth, uint32_t screenHeight) {
+    // largeur fixe, hauteur arrondie a des tuiles entieres (chaque axe garde sa propre echelle)
+    m_Width = OCCLUSION_WIDTH;
+    float rows = (float)OCCLUSION_WIDTH * screenHeight / std::max(screenWidth, 1u) / OCCLUSION_TILE_SIZE;
+    m_Height = std::max((uint32_t)(rows + 0.5f), 1u) * OCCLUSION_TILE_SIZE;
+    m_TilesX = m_Width / OCCLUSION_TILE_SIZE;
+    m_TilesY = m_Height / OCCLUSION_TILE_SIZE;
+    m_Depth.assign((size_t)m_Width * m_Height, 1.0f);
+    m_TileMax.assign((size_t)m_TilesX * m_TilesY, 1.0f);
+}
+
+void OcclusionBuffer::SetOccluderMesh(const Vec3* positions, size_t vertexCount, const uint32_t* indices, size_t indexCount) {
+    m_Positions.assign(positions, positions + vertexCount);
+    m_Indices.assign(indices, indices + indexCount - indexCount % 3);
+
+    // voisin de chaque arete (v0 v1, v1 v2, v2 v0) quand elle est partagee par exactement deux triangles,
+    // vertex soudes par position (coutures d'UV) ; sinon l'arete reste toujours une silhouette
+    std::vector<uint32_t>& weld = m_Weld;
+    weld.resize(vertexCount);
+    std::map<std::tuple<float, float, float>, uint32_t> unique;
+    for (size_t v = 0; v < vertexCount; v++) weld[v] = unique.emplace(std::make_tuple(positions[v].x, positions[v].y, positions[v].z), (uint32_t)v).first->second;
+
+    std::map<std::pair<uint32_t, uint32_t>, std::vector<uint32_t>> edges;
+    for (size_t corner = 0; corner < m_Indices.size(); corner++) {
+        uint32_t a = weld[m_Indices[corner]];
+        uint32_t b = weld[m_Indices[corner % 3 == 2 ? corner - 2 : corner + 1]];
+        edges[std::make_pair(std::min(a, b), std::max(a, b))].push_back((uint32_t)corner);
+    }
+    m_Adjacency.assign(m_Indices.size(), UINT32_MAX);
+    for (const auto& edge : edges) {
+        if (edge.second.size() != 2) continue;
+        m_Adjacency[edge.second[0]] = edge.second[1] / 3;
+        m_Adjacency[edge.second[1]] = edge.second[0] / 3;
+    }
+}
+
+uint32_t OcclusionBuffer::GetOccluderBudget() const {
+    size_t triangles = m_Indices.size() / 3;
+    return triangles ? (uint32_t)std::max<size_t>(OCCLUSION_TRIANGLE_BUDGET / triangles, 1) : 0;
+}
+
+void OcclusionBuffer::Render(JobSystem& jobs, const Mat4& viewProjection, const Mat4* models, size_t occluderCount) {
+    m_ViewProjection = viewProjection;
+    size_t trianglesPerOccluder = m_Indices.size() / 3;
+    m_Triangles.resize(occluderCount * trianglesPerOccluder);
+
+    jobs.ParallelFor(occluderCount, OCCLUDER_JOB_GRAIN, [&](size_t begin, size_t end) {
+        PROFILE_SCOPE("occluder setup");
+        std::vector<Vec4> screen(m_Positions.size());
+        std::vector<uint8_t> front(trianglesPerOccluder);
+        std::vector<uint8_t> silhouette(m_Positions.size());
+        for (size_t i = begin; i < end; i++) {
+            SetupOccluder(multiplyMat4(models[i], viewProjection), &m_Triangles[i * trianglesPerOccluder], screen, front, silhouette);
+        }
+    });
+
+    // triangles ranges par rangee de tuiles, dans l'ordre
+    {
+        PROFILE_SCOPE("occluder binning");
+        m_Bands.resize(m_TilesY);
+        for (std::vector<uint32_t>& band : m_Bands) band.clear();
+        for (size_t t = 0; t < m_Triangles.size(); t++) {
+            const OccluderTriangle& triangle = m_Triangles[t];
+            if (triangle.minX > triangle.maxX) continue;
+            for (int32_t row = triangle.minY / (int32_t)OCCLUSION_TILE_SIZE; row <= triangle.maxY / (int32_t)OCCLUSION_TILE_SIZE; row++)
+                m_Bands[row].push_back((uint32_t)t);
+        }
+    }
+
+    // une rangee de tuiles par job : aucun pixel n'est partage entre deux jobs
+    jobs.ParallelFor(m_TilesY, 1, [&](size_t begin, size_t end) {
+        PROFILE_SCOPE("occluder raster");
+        for (size_t row = begin; row < end; row++) RasterizeBand((uint32_t)row);
+    });
+}
+
+void OcclusionBuffer::SetupOccluder(const Mat4& modelViewProjection, OccluderTriangle* triangles, std::vector<Vec4>& screen, std::vector<uint8_t>& front,
+    std::vector<uint8_t>& silhouette) const {
+    // pixels, y vers le bas ; w < OCCLUSION_MIN_W marque un vertex derriere la camera
+    for (size_t v = 0; v < m_Positions.size(); v++) {
+        const Vec3& p = m_Positions[v];
+        Vec4 clip = transformVec4(modelViewProjection, { p.x, p.y, p.z, 1.0f });
+        float invW = 1.0f / std::max(clip.w, OCCLUSION_MIN_W);
+        screen[v] = { (clip.x * invW * 0.5f + 0.5f) * m_Width, (0.5f - clip.y * invW * 0.5f) * m_Height, clip.z * invW, clip.w };
+    }
+
+    // faces avant (sens trigonometrique a l'ecran une fois y retourne) dont aucun vertex n'est derriere la camera ;
+    // les faces arriere d'un occulteur ferme sont toujours cachees par une face avant
+    size_t triangleCount = m_Indices.size() / 3;
+    for (size_t t = 0; t < triangleCount; t++) {
+        const Vec4& a = screen[m_Indices[t * 3]];
+        const Vec4& b = screen[m_Indices[t * 3 + 1]];
+        const Vec4& c = screen[m_Indices[t * 3 + 2]];
+        bool visible = a.w >= OCCLUSION_MIN_W && b.w >= OCCLUSION_MIN_W && c.w >= OCCLUSION_MIN_W;
+        front[t] = visible && (c.x - a.x) * (b.y - a.y) - (b.x - a.x) * (c.y - a.y) > 0.0f;
+    }
+
+    // sommets (soudes) des aretes de silhouette : face avant dont le voisin est absent ou pas dessine
+    std::fill(silhouette.begin(), silhouette.end(), 0);
+    for (size_t t = 0; t < triangleCount; t++) {
+        if (!front[t]) continue;
+        for (int e = 0; e < 3; e++) {
+            uint32_t neighbor = m_Adjacency[t * 3 + e];
+            if (neighbor != UINT32_MAX && front[neighbor]) continue;
+            silhouette[m_Weld[m_Indices[t * 3 + e]]] = 1;
+            silhouette[m_Weld[m_Indices[t * 3 + (e + 1) % 3]]] = 1;
+        }
+    }
+
+    for (size_t t = 0; t < triangleCount; t++) {
+        OccluderTriangle& triangle = triangles[t];
+        triangle.minX = 1;
+        triangle.maxX = 0;
+        if (!front[t]) continue;
+
+        // ordre 0, 2, 1 pour que les fonctions d'arete soient positives a l'interieur
+        static const int ORDER[3] = { 0, 2, 1 };
+        float x[3], y[3], z[3];
+        for (int k = 0; k < 3; k++) {
+            const Vec4& v = screen[m_Indices[t * 3 + ORDER[k]]];
+            x[k] = v.x;
+            y[k] = v.y;
+            z[k] = v.z;
+        }
+        float area = (x[1] - x[0]) * (y[2] - y[0]) - (x[2] - x[0]) * (y[1] - y[0]);
+
+        // pixels dont le centre tombe dans la boite du triangle
+        float minX = std::min({ x[0], x[1], x[2] }), maxX = std::max({ x[0], x[1], x[2] });
+        float minY = std::min({ y[0], y[1], y[2] }), maxY = std::max({ y[0], y[1], y[2] });
+        if (maxX < 0.0f || maxY < 0.0f || minX > (float)m_Width || minY > (float)m_Height) continue;
+        triangle.minX = std::max((int32_t)ceilf(minX - 0.5f), 0);
+        triangle.minY = std::max((int32_t)ceilf(minY - 0.5f), 0);
+        triangle.maxX = std::min((int32_t)floorf(maxX - 0.5f), (int32_t)m_Width - 1);
+        triangle.maxY = std::min((int32_t)floorf(maxY - 0.5f), (int32_t)m_Height - 1);
+        if (triangle.minY > triangle.maxY) triangle.maxX = triangle.minX - 1;
+        if (triangle.minX > triangle.maxX) continue;
+
+        // un triangle qui touche la silhouette ne compte que les pixels entierement a l'interieur, sur ses trois
+        // aretes : un pixel a cheval sur une arete interne pres d'un sommet de silhouette pourrait sinon deborder
+        // du voisin ; une fente plus fine qu'un pixel entre deux occulteurs reste ouverte, et les triangles
+        // interieurs gardent l'echantillonnage au centre pour ne pas laisser de fissures
+        bool conservative = silhouette[m_Weld[m_Indices[t * 3]]] || silhouette[m_Weld[m_Indices[t * 3 + 1]]] || silhouette[m_Weld[m_Indices[t * 3 + 2]]];
+        for (int k = 0; k < 3; k++) {
+            int i = (k + 1) % 3, j = (k + 2) % 3;
+            triangle.edgeA[k] = y[i] - y[j];
+            triangle.edgeB[k] = x[j] - x[i];
+            triangle.edgeC[k] = x[i] * y[j] - y[i] * x[j];
+            if (conservative) triangle.edgeC[k] -= 0.5f * (fabsf(triangle.edgeA[k]) + fabsf(triangle.edgeB[k]));
+        }
+
+        // profondeur du coin le plus lointain du pixel
+        float dzdx = ((z[1] - z[0]) * (y[2] - y[0]) - (z[2] - z[0]) * (y[1] - y[0])) / area;
+        float dzdy = ((z[2] - z[0]) * (x[1] - x[0]) - (z[1] - z[0]) * (x[2] - x[0])) / area;
+        triangle.depth[0] = z[0] + dzdx * (triangle.minX + 0.5f - x[0]) + dzdy * (triangle.minY + 0.5f - y[0]) + 0.5f * (fabsf(dzdx) + fabsf(dzdy));
+        triangle.depth[1] = dzdx;
+        triangle.depth[2] = dzdy;
+    }
+}
+
+void OcclusionBuffer::RasterizeBand(uint32_t tileRow) {
+    int32_t bandY0 = (int32_t)(tileRow * OCCLUSION_TILE_SIZE);
+    int32_t bandY1 = bandY0 + (int32_t)OCCLUSION_TILE_SIZE - 1;
+    float* band = &m_Depth[(size_t)bandY0 * m_Width];
+    std::fill(band, band + (size_t)OCCLUSION_TILE_SIZE * m_Width, 1.0f);
+
+    for (uint32_t t : m_Bands[tileRow]) {
+        const OccluderTriangle& triangle = m_Triangles[t];
+        // groupes de 4 pixels alignes, la largeur du tampon est un multiple de 4
+        int32_t x0 = triangle.minX & ~3;
+        int32_t x1 = triangle.maxX;
+        int32_t y0 = std::max(triangle.minY, bandY0);
+        int32_t y1 = std::min(triangle.maxY, bandY1);
+
+#if defined(MATH_SIMD_SSE)
+        const __m128 laneOffsets = _mm_setr_ps(0.0f, 1.0f, 2.0f, 3.0f);
+        const __m128 zero = _mm_setzero_ps();
+        __m128 laneStep[3], groupStep[3];
+        for (int k = 0; k < 3; k++) {
+            laneStep[k] = _mm_mul_ps(_mm_set1_ps(triangle.edgeA[k]), laneOffsets);
+            groupStep[k] = _mm_set1_ps(4.0f * triangle.edgeA[k]);
+        }
+        __m128 depthStep = _mm_set1_ps(triangle.depth[1]);
+        for (int32_t py = y0; py <= y1; py++) {
+            float sampleY = py + 0.5f, sampleX = x0 + 0.5f;
+            __m128 edge[3];
+            for (int k = 0; k < 3; k++)
+                edge[k] = _mm_add_ps(_mm_set1_ps(triangle.edgeA[k] * sampleX + triangle.edgeB[k] * sampleY + triangle.edgeC[k]), laneStep[k]);
+            float depthRow = triangle.depth[0] + triangle.depth[2] * (py - triangle.minY);
+            float* row = &m_Depth[(size_t)py * m_Width];
+            for (int32_t px = x0; px <= x1; px += 4) {
+                __m128 inside = _mm_and_ps(_mm_and_ps(_mm_cmpge_ps(edge[0], zero), _mm_cmpge_ps(edge[1], zero)), _mm_cmpge_ps(edge[2], zero));
+                if (_mm_movemask_ps(inside)) {
+                    __m128 fx = _mm_add_ps(_mm_set1_ps((float)(px - triangle.minX)), laneOffsets);
+                    __m128 depth = _mm_add_ps(_mm_set1_ps(depthRow), _mm_mul_ps(depthStep, fx));
+                    __m128 stored = _mm_loadu_ps(row + px);
+                    _mm_storeu_ps(row + px, _mm_or_ps(_mm_and_ps(inside, _mm_min_ps(depth, stored)), _mm_andnot_ps(inside, stored)));
+                }
+                for (int k = 0; k < 3; k++) edge[k] = _mm_add_ps(edge[k], groupStep[k]);
+            }
+        }
+#elif defined(MATH_SIMD_NEON)
+        const float laneValues[4] = { 0.0f, 1.0f, 2.0f, 3.0f };
+        const float32x4_t laneOffsets = vld1q_f32(laneValues);
+        const float32x4_t zero = vdupq_n_f32(0.0f);
+        float32x4_t laneStep[3], groupStep[3];
+        for (int k = 0; k < 3; k++) {
+            laneStep[k] = vmulq_n_f32(laneOffsets, triangle.edgeA[k]);
+            groupStep[k] = vdupq_n_f32(4.0f * triangle.edgeA[k]);
+        }
+        for (int32_t py = y0; py <= y1; py++) {
+            float sampleY = py + 0.5f, sampleX = x0 + 0.5f;
+            float32x4_t edge[3];
+            for (int k = 0; k < 3; k++)
+                edge[k] = vaddq_f32(vdupq_n_f32(triangle.edgeA[k] * sampleX + triangle.edgeB[k] * sampleY + triangle.edgeC[k]), laneStep[k]);
+            float depthRow = triangle.depth[0] + triangle.depth[2] * (py - triangle.minY);
+            float* row = &m_Depth[(size_t)py * m_Width];
+            for (int32_t px = x0; px <= x1; px += 4) {
+                uint32x4_t inside = vandq_u32(vandq_u32(vcgeq_f32(edge[0], zero), vcgeq_f32(edge[1], zero)), vcgeq_f32(edge[2], zero));
+                if (vmaxvq_u32(inside)) {
+                    float32x4_t fx = vaddq_f32(vdupq_n_f32((float)(px - triangle.minX)), laneOffsets);
+                    float32x4_t depth = vaddq_f32(vdupq_n_f32(depthRow), vmulq_n_f32(fx, triangle.depth[1]));
+                    float32x4_t stored = vld1q_f32(row + px);
+                    vst1q_f32(row + px, vbslq_f32(inside, vminq_f32(depth, stored), stored));
+                }
+                for (int k = 0; k < 3; k++) edge[k] = vaddq_f32(edge[k], groupStep[k]);
+            }
+        }
+#else
+        for (int32_t py = y0; py <= y1; py++) {
+            float sampleY = py + 0.5f;
+            float depthRow = triangle.depth[0] + triangle.depth[2] * (py - triangle.minY);
+            float* row = &m_Depth[(size_t)py * m_Width];
+            for (int32_t px = x0; px <= x1; px++) {
+                float sampleX = px + 0.5f;
+                bool inside = true;
+                for (int k = 0; k < 3; k++) inside &= triangle.edgeA[k] * sampleX + triangle.edgeB[k] * sampleY + triangle.edgeC[k] >= 0.0f;
+                if (inside) row[px] = std::min(row[px], depthRow + triangle.depth[1] * (px - triangle.minX));
+            }
+        }
+#endif
+    }
+
+
+    // profondeur la plus lointaine de chaque tuile de la rangee
+    for (uint32_t tileX = 0; tileX < m_TilesX; tileX++) {
+        float farthest = -INFINITY;
+        for (uint32_t y = 0; y < OCCLUSION_TILE_SIZE; y++) {
+            const float* row = band + (size_t)y * m_Width + tileX * OCCLUSION_TILE_SIZE;
+            for (uint32_t x = 0; x < OCCLUSION_TILE_SIZE; x++) farthest = std::max(farthest, row[x]);
+        }
+        m_TileMax[tileRow * m_TilesX + tileX] = farthest;
+    }
+}
+
+bool OcclusionBuffer::TestAabb(const Vec3& boundsMin, const Vec3& boundsMax) const {
+    // rectangle ecran et profondeur la plus proche des 8 coins
+    float minX = INFINITY, minY = INFINITY, maxX = -INFINITY, maxY = -INFINITY, nearest = INFINITY;
+    for (int corner = 0; corner < 8; corner++) {
+        Vec4 point = {
+            corner & 1 ? boundsMax.x : boundsMin.x,
+            corner & 2 ? boundsMax.y : boundsMin.y,
+            corner & 4 ? boundsMax.z : boundsMin.z,
+            1.0f
+        };
+        Vec4 clip = transformVec4(m_ViewProjection, point);
+        if (clip.w < OCCLUSION_MIN_W) return true;
+        float invW = 1.0f / clip.w;
+        float x = (clip.x * invW * 0.5f + 0.5f) * m_Width;
+        float y = (0.5f - clip.y * invW * 0.5f) * m_Height;
+        minX = std::min(minX, x);
+        maxX = std::max(maxX, x);
+        minY = std::min(minY, y);
+        maxY = std::max(maxY, y);
+        nearest = std::min(nearest, clip.z * invW);
+    }
+
+    // tous les pixels que le rectangle touche
+    int32_t x0 = std::max((int32_t)floorf(std::max(minX, -1.0f)), 0);
+    int32_t y0 = std::max((int32_t)floorf(std::max(minY, -1.0f)), 0);
+    int32_t x1 = std::min((int32_t)floorf(std::min(maxX, (float)m_Width)), (int32_t)m_Width - 1);
+    int32_t y1 = std::min((int32_t)floorf(std::min(maxY, (float)m_Height)), (int32_t)m_Height - 1);
+    if (x0 > x1 || y0 > y1) return true;
+
+    for (int32_t tileY = y0 / (int32_t)OCCLUSION_TILE_SIZE; tileY <= y1 / (int32_t)OCCLUSION_TILE_SIZE; tileY++) {
+        for (int32_t tileX = x0 / (int32_t)OCCLUSION_TILE_SIZE; tileX <= x1 / (int32_t)OCCLUSION_TILE_SIZE; tileX++) {
+            // toute la tuile est devant la boite
+            if (m_TileMax[tileY * m_TilesX + tileX] < nearest) continue;
+
+            int32_t startX = std::max(x0, tileX * (int32_t)OCCLUSION_TILE_SIZE);
+            int32_t endX = std::min(x1, tileX * (int32_t)OCCLUSION_TILE_SIZE + (int32_t)OCCLUSION_TILE_SIZE - 1);
+            int32_t startY = std::max(y0, tileY * (int32_t)OCCLUSION_TILE_SIZE);
+            int32_t endY = std::min(y1, tileY * (int32_t)OCCLUSION_TILE_SIZE + (int32_t)OCCLUSION_TILE_SIZE - 1);
+            for (int32_t y = startY; y <= endY; y++) {
+                const float* row = &m_Depth[(size_t)y * m_Width];
+                for (int32_t x = startX; x <= endX; x++)
+                    if (row[x] >= nearest) return true;
+            }
+        }
+    }
+    return false;
+}
+
+size_t OcclusionBuffer::Cull(JobSystem& jobs, const SphereBounds& bounds, uint32_t* indices, size_t count) {
+    const float* x = bounds.GetX();
+    const float* y = bounds.GetY();
+    const float* z = bounds.GetZ();
+    const float* radius = bounds.GetRadius();
+    m_Visible.resize(count);
+    jobs.ParallelFor(count, OCCLUSION_TEST_GRAIN, [&](size_t begin, size_t end) {
+        PROFILE_SCOPE("occlusion test");
+        for (size_t k = begin; k < end; k++) {
+            uint32_t i = indices[k];
+            m_Visible[k] = TestAabb({ x[i] - radius[i], y[i] - radius[i], z[i] - radius[i] }, { x[i] + radius[i], y[i] + radius[i], z[i] + radius[i] });
+        }
+    });
+
+    size_t visible = 0;
+    for (size_t k = 0; k < count; k++) {
+        if (m_Visible[k]) indices[visible++] = indices[k];
+    }
+    return visible;
+}
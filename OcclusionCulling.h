@@ -0,0 +1,66 @@
+#pragma once
+
+#include "MathUtils.h"
+#include "Culling.h"
+#include "JobSystem.h"
+#include <cstdint>
+#include <cstddef>
+#include <vector>
+
+// occlusion culling sur CPU facon Hi-Z : les occulteurs les plus proches (mesh simplifie) sont rasterises en
+// profondeur seule dans un tampon basse resolution, puis la boite de chaque objet est comparee au max de
+// profondeur des tuiles qu'elle couvre, et pixel par pixel pour les tuiles qui ne suffisent pas a conclure
+const uint32_t OCCLUSION_WIDTH = 256;          // hauteur deduite du rapport d'aspect
+const uint32_t OCCLUSION_TILE_SIZE = 8;
+const uint32_t OCCLUSION_TRIANGLE_BUDGET = 65536;   // triangles d'occulteurs rasterises par frame
+
+class OcclusionBuffer {
+public:
+    OcclusionBuffer();
+
+    // taille de l'ecran, pour garder le rapport d'aspect
+    void Create(uint32_t screenWidth, uint32_t screenHeight);
+
+    // mesh commun a tous les occulteurs, dans le repere des matrices model passees a Render
+    void SetOccluderMesh(const Vec3* positions, size_t vertexCount, const uint32_t* indices, size_t indexCount);
+    // nombre d'occulteurs qui tiennent dans OCCLUSION_TRIANGLE_BUDGET
+    uint32_t GetOccluderBudget() const;
+
+    // efface le tampon et rasterise un occulteur par matrice model, en bandes de tuiles reparties sur les jobs
+    void Render(JobSystem& jobs, const Mat4& viewProjection, const Mat4* models, size_t occluderCount);
+
+    // garde dans indices[0, count) les objets dont la boite englobant la sphere peut etre visible, dans l'ordre,
+    // et renvoie leur nombre ; les tests sont repartis sur les jobs
+    size_t Cull(JobSystem& jobs, const SphereBounds& bounds, uint32_t* indices, size_t count);
+
+    // vrai si une partie de la boite peut depasser des occulteurs (toujours vrai si elle coupe le plan proche)
+    bool TestAabb(const Vec3& boundsMin, const Vec3& boundsMax) const;
+
+    uint32_t GetWidth() const { return m_Width; }
+    uint32_t GetHeight() const { return m_Height; }
+
+private:
+    // fonctions d'arete E = A x + B y + C aux centres de pixels (>= 0 a l'interieur) et plan de profondeur z/w
+    struct OccluderTriangle {
+        float edgeA[3], edgeB[3], edgeC[3];
+        float depth[3];   // z au pixel (minX, minY), pentes en x et en y
+        int32_t minX, minY, maxX, maxY;   // vide (minX > maxX) si le triangle est rejete
+    };
+
+    uint32_t m_Width, m_Height;
+    uint32_t m_TilesX, m_TilesY;
+    std::vector<float> m_Depth;     // z/w le plus proche par pixel, 1 = plan lointain
+    std::vector<float> m_TileMax;   // z/w le plus lointain de chaque tuile
+    std::vector<Vec3> m_Positions;
+    std::vector<uint32_t> m_Indices;
+    std::vector<uint32_t> m_Weld;        // par vertex : premier vertex de meme position
+    std::vector<uint32_t> m_Adjacency;   // par arete de chaque triangle : triangle voisin ou UINT32_MAX
+    std::vector<OccluderTriangle> m_Triangles;
+    std::vector<std::vector<uint32_t>> m_Bands;   // indices des triangles qui touchent chaque rangee de tuiles
+    std::vector<uint8_t> m_Visible;
+    Mat4 m_ViewProjection;
+
+    void SetupOccluder(const Mat4& modelViewProjection, OccluderTriangle* triangles, std::vector<Vec4>& screen, std::vector<uint8_t>& front,
+        std::vector<uint8_t>& silhouette) const;
+    void RasterizeBand(uint32_t tileRow);
+};
@@ -0,0 +1,83 @@
+#include "PngWriter.h"
+#include <algorithm>
+#include <fstream>
+#include <vector>
+
+static std::vector<uint32_t> buildCrcTable() {
+    std::vector<uint32_t> table(256);
+    for (uint32_t n = 0; n < 256; n++) {
+        uint32_t c = n;
+        for (int k = 0; k < 8; k++) c = c & 1 ? 0xEDB88320u ^ (c >> 1) : c >> 1;
+        table[n] = c;
+    }
+    return table;
+}
+
+static uint32_t updateCrc(uint32_t crc, const uint8_t* data, size_t size) {
+    static const std::vector<uint32_t> table = buildCrcTable();
+    for (size_t i = 0; i < size; i++) crc = table[(crc ^ data[i]) & 0xFF] ^ (crc >> 8);
+    return crc;
+}
+
+static void appendBigEndian(std::vector<uint8_t>& out, uint32_t value) {
+    for (int shift = 24; shift >= 0; shift -= 8) out.push_back((uint8_t)(value >> shift));
+}
+
+// longueur, type, donnees, CRC du type et des donnees
+static void writeChunk(std::ofstream& file, const char* type, const std::vector<uint8_t>& data) {
+    std::vector<uint8_t> chunk;
+    appendBigEndian(chunk, (uint32_t)data.size());
+    chunk.insert(chunk.end(), type, type + 4);
+    chunk.insert(chunk.end(), data.begin(), data.end());
+    uint32_t crc = updateCrc(0xFFFFFFFFu, chunk.data() + 4, chunk.size() - 4) ^ 0xFFFFFFFFu;
+    appendBigEndian(chunk, crc);
+    file.write((const char*)chunk.data(), chunk.size());
+}
+
+bool writePng(const char* path, const uint8_t* rgba, uint32_t width, uint32_t height, size_t rowPitch, bool flipY) {
+    // lignes precedees de leur filtre (0 : aucun)
+    std::vector<uint8_t> raw;
+    raw.reserve((size_t)height * (width * 3 + 1));
+    for (uint32_t y = 0; y < height; y++) {
+        const uint8_t* row = rgba + (size_t)(flipY ? height - 1 - y : y) * rowPitch;
+        raw.push_back(0);
+        for (uint32_t x = 0; x < width; x++) raw.insert(raw.end(), row + x * 4, row + x * 4 + 3);
+    }
+
+    // flux zlib en blocs "stored" d'au plus 65535 octets, suivi de l'Adler-32
+    std::vector<uint8_t> zlib = { 0x78, 0x01 };
+    const size_t maxBlock = 65535;
+    size_t offset = 0;
+    do {
+        size_t size = std::min(maxBlock, raw.size() - offset);
+        bool last = offset + size == raw.size();
+        zlib.push_back(last ? 1 : 0);
+        zlib.push_back((uint8_t)size);
+        zlib.push_back((uint8_t)(size >> 8));
+        zlib.push_back((uint8_t)~size);
+        zlib.push_back((uint8_t)(~size >> 8));
+        zlib.insert(zlib.end(), raw.begin() + offset, raw.begin() + offset + size);
+        offset += size;
+    } while (offset < raw.size());
+    uint32_t a = 1, b = 0;
+    for (uint8_t byte : raw) {
+        a = (a + byte) % 65521;
+        b = (b + a) % 65521;
+    }
+    appendBigEndian(zlib, (b << 16) | a);
+
+    std::ofstream file(path, std::ios::out | std::ios::binary | std::ios::trunc);
+    if (!file) return false;
+    const uint8_t signature[8] = { 0x89, 'P', 'N', 'G', '\r', '\n', 0x1A, '\n' };
+    file.write((const char*)signature, sizeof(signature));
+
+    // IHDR : largeur, hauteur, 8 bits, RGB, compression / filtre / entrelacement standard
+    std::vector<uint8_t> header;
+    appendBigEndian(header, width);
+    appendBigEndian(header, height);
+    header.insert(header.end(), { 8, 2, 0, 0, 0 });
+    writeChunk(file, "IHDR", header);
+    writeChunk(file, "IDAT", zlib);
+    writeChunk(file, "IEND", {});
+    return (bool)file;
+}
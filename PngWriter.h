@@ -0,0 +1,8 @@
+#pragma once
+
+#include <cstdint>
+#include <cstddef>
+
+// ecrit une image RGBA 8 bits en PNG RGB (alpha ignore), sans dependance : blocs zlib non compresses
+// rowPitch en octets ; flipY pour les images lues par glReadPixels (premiere ligne en bas)
+bool writePng(const char* path, const uint8_t* rgba, uint32_t width, uint32_t height, size_t rowPitch, bool flipY = false);
@@ -0,0 +1,128 @@
+#include "Profiler.h"
+
+#if PROFILER_ENABLED
+
+#include <atomic>
+#include <chrono>
+#include <fstream>
+#include <iomanip>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <vector>
+
+struct ProfileEvent {
+    const char* name;
+    uint64_t start;   // ns depuis le demarrage du programme
+    uint64_t end;
+};
+
+// zones d'un thread : lui seul ecrit, count publie les evenements complets (release) pour l'export (acquire)
+struct ProfileThread {
+    uint32_t id;
+    std::string name;                                    // sous profilerMutex
+    std::atomic<ProfileEvent*> blocks[PROFILER_MAX_BLOCKS];   // alloues a la demande
+    std::atomic<uint32_t> count;
+    std::atomic<uint32_t> dropped;
+
+    ~ProfileThread() {
+        for (std::atomic<ProfileEvent*>& block : blocks) delete[] block.load();
+    }
+};
+
+static const std::chrono::steady_clock::time_point profilerEpoch = std::chrono::steady_clock::now();
+static std::mutex profilerMutex;
+static std::vector<std::unique_ptr<ProfileThread>> profilerThreads;   // gardes apres la fin des threads pour l'export
+static thread_local ProfileThread* currentThread = nullptr;
+
+static uint64_t profilerNow() {
+    return (uint64_t)std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now() - profilerEpoch).count();
+}
+
+// enregistre le thread appelant a sa premiere zone
+static ProfileThread& getProfileThread() {
+    if (!currentThread) {
+        std::unique_ptr<ProfileThread> thread = std::make_unique<ProfileThread>();
+        std::lock_guard<std::mutex> lock(profilerMutex);
+        thread->id = (uint32_t)profilerThreads.size() + 1;
+        currentThread = thread.get();
+        profilerThreads.push_back(std::move(thread));
+    }
+    return *currentThread;
+}
+
+ProfileZone::ProfileZone(const char* name) : m_Name(name), m_Start(profilerNow()) {}
+
+ProfileZone::~ProfileZone() {
+    uint64_t end = profilerNow();
+    ProfileThread& thread = getProfileThread();
+    uint32_t index = thread.count.load(std::memory_order_relaxed);
+    uint32_t block = index / PROFILER_BLOCK_EVENTS;
+    if (block >= PROFILER_MAX_BLOCKS) {
+        thread.dropped.fetch_add(1, std::memory_order_relaxed);
+        return;
+    }
+    ProfileEvent* events = thread.blocks[block].load(std::memory_order_relaxed);
+    if (!events) {
+        events = new ProfileEvent[PROFILER_BLOCK_EVENTS];
+        thread.blocks[block].store(events, std::memory_order_relaxed);
+    }
+    events[index % PROFILER_BLOCK_EVENTS] = { m_Name, m_Start, end };
+    thread.count.store(index + 1, std::memory_order_release);
+}
+
+void setProfilerThreadName(const char* name, int index) {
+    ProfileThread& thread = getProfileThread();
+    std::lock_guard<std::mutex> lock(profilerMutex);
+    thread.name = index >= 0 ? std::string(name) + " " + std::to_string(index) : name;
+}
+
+// chaine JSON entre guillemets
+static void writeJsonString(std::ofstream& file, const char* text) {
+    file << '"';
+    for (const char* c = text; *c; c++) {
+        if (*c == '"' || *c == '\\') file << '\\';
+        file << *c;
+    }
+    file << '"';
+}
+
+bool writeChromeTrace(const char* path) {
+    std::ofstream file(path, std::ios::out | std::ios::trunc);
+    if (!file) return false;
+
+    // evenements complets ("X") en microsecondes, et un nom par fil ("M")
+    file << std::fixed << std::setprecision(3);
+    file << "{\"displayTimeUnit\":\"ms\",\"traceEvents\":[";
+    std::lock_guard<std::mutex> lock(profilerMutex);
+    bool first = true;
+    for (const std::unique_ptr<ProfileThread>& thread : profilerThreads) {
+        std::string name = thread->name.empty() ? "thread " + std::to_string(thread->id) : thread->name;
+        uint32_t dropped = thread->dropped.load(std::memory_order_relaxed);
+        if (dropped) name += " (" + std::to_string(dropped) + " zones perdues)";
+        file << (first ? "" : ",") << "\n{\"name\":\"thread_name\",\"ph\":\"M\",\"pid\":1,\"tid\":" << thread->id << ",\"args\":{\"name\":";
+        writeJsonString(file, name.c_str());
+        file << "}},\n{\"name\":\"thread_sort_index\",\"ph\":\"M\",\"pid\":1,\"tid\":" << thread->id << ",\"args\":{\"sort_index\":" << thread->id << "}}";
+        first = false;
+
+        uint32_t count = thread->count.load(std::memory_order_acquire);
+        for (uint32_t i = 0; i < count; i++) {
+            const ProfileEvent& event = thread->blocks[i / PROFILER_BLOCK_EVENTS].load(std::memory_order_relaxed)[i % PROFILER_BLOCK_EVENTS];
+            file << ",\n{\"name\":";
+            writeJsonString(file, event.name);
+            file << ",\"ph\":\"X\",\"pid\":1,\"tid\":" << thread->id << ",\"ts\":" << event.start / 1000.0 << ",\"dur\":" << (event.end - event.start) / 1000.0 << "}";
+        }
+    }
+    file << "\n]}\n";
+    return (bool)file;
+}
+
+#else
+
+void setProfilerThreadName(const char*, int) {}
+
+bool writeChromeTrace(const char*) {
+    return false;
+}
+
+#endif
@@ -0,0 +1,55 @@
+#pragma once
+
+#include <cstdint>
+
+// profileur CPU par zones : actif en debug, retire des builds release sauf si PROFILER_ENABLED=1 est defini
+// (PROFILER_ENABLED=0 le retire aussi en debug) ; sans lui les macros ne generent aucun code
+#if !defined(PROFILER_ENABLED)
+#if defined(NDEBUG)
+#define PROFILER_ENABLED 0
+#else
+#define PROFILER_ENABLED 1
+#endif
+#endif
+
+// zones enregistrees par thread au-dela desquelles les suivantes sont perdues (comptees dans la trace)
+const uint32_t PROFILER_BLOCK_EVENTS = 4096;
+const uint32_t PROFILER_MAX_BLOCKS = 256;
+
+#if PROFILER_ENABLED
+
+// mesure de la construction a la destruction ; name doit rester valide jusqu'a l'export (chaine statique)
+// chaque thread ecrit dans ses propres blocs, sans verrou : seul l'enregistrement du thread en prend un
+class ProfileZone {
+public:
+    explicit ProfileZone(const char* name);
+    ~ProfileZone();
+    ProfileZone(const ProfileZone&) = delete;
+    ProfileZone& operator=(const ProfileZone&) = delete;
+
+private:
+    const char* m_Name;
+    uint64_t m_Start;
+};
+
+#define PROFILE_CONCAT_INNER(a, b) a##b
+#define PROFILE_CONCAT(a, b) PROFILE_CONCAT_INNER(a, b)
+#define PROFILE_SCOPE(name) ProfileZone PROFILE_CONCAT(profileZone, __LINE__)(name)
+#define PROFILE_FUNCTION() PROFILE_SCOPE(__func__)
+#define PROFILE_THREAD_NAME(...) setProfilerThreadName(__VA_ARGS__)
+
+#else
+
+#define PROFILE_SCOPE(name) ((void)0)
+#define PROFILE_FUNCTION() ((void)0)
+#define PROFILE_THREAD_NAME(...) ((void)0)
+
+#endif
+
+// nom du thread appelant dans la trace, suivi de index s'il est positif
+void setProfilerThreadName(const char* name, int index = -1);
+
+// toutes les zones terminees au format Chrome trace (chrome://tracing, ui.perfetto.dev), un fil par thread ;
+// les zones des autres threads sont lues sans les arreter, celles encore ouvertes n'apparaissent pas
+// false si le fichier ne peut pas etre ecrit ou si le profileur est retire a la compilation
+bool writeChromeTrace(const char* path);
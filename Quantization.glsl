@@ -0,0 +1,13 @@
+// decodage des vertex compresses par MeshConverter --quantize
+#ifdef QUANTIZED
+// centre et demi-etendue de l'AABB du mesh
+uniform vec3 meshCenter;
+uniform vec3 meshExtent;
+
+vec3 decodeOctahedral(vec2 e) {
+    vec3 n = vec3(e, 1.0 - abs(e.x) - abs(e.y));
+    float t = max(-n.z, 0.0);
+    n.xy += vec2(n.x >= 0.0 ? -t : t, n.y >= 0.0 ? -t : t);
+    return normalize(n);
+}
+#endif
@@ -0,0 +1,130 @@
+#include "RenderQueue.h"
+#include "GLStateCache.h"
+#include "UniformBuffer.h"
+#include "Benchmark.h"
+#include <GL/glew.h>
+#include <GL/gl.h>
+#include <cstring>
+#include <algorithm>
+
+// les bits d'un float positif sont dans le meme ordre que sa valeur : on garde l'exposant
+// et 10 bits de mantisse, une precision relative de 1/1024 suffit pour ordonner les objets
+static uint32_t depthBits(float depth) {
+    if (!(depth > 0.0f)) return 0;   // derriere la camera ou NaN
+    uint32_t bits;
+    memcpy(&bits, &depth, sizeof(bits));
+    return bits >> 13;
+}
+
+uint64_t makeSortKey(RenderPass pass, uint32_t program, uint32_t material, float viewDepth) {
+    uint64_t key = (uint64_t)pass << 62;
+    uint64_t state = ((uint64_t)(program & 0xFFF) << 12) | (material & 0xFFF);
+    uint64_t depth = depthBits(viewDepth);
+    if (pass == RENDER_PASS_TRANSPARENT) {
+        return key | ((~depth & 0x3FFFF) << 44) | (state << SORT_KEY_PACKET_BITS);
+    }
+    return key | (state << 38) | (depth << SORT_KEY_PACKET_BITS);
+}
+
+void RenderQueue::Reserve(size_t count) {
+    m_Packets.reserve(count);
+    m_Keys.reserve(count);
+    m_Scratch.reserve(count);
+}
+
+void RenderQueue::Sort() {
+    size_t count = m_Keys.size();
+    if (count < 2) return;
+    m_Scratch.resize(count);
+
+    // seuls les bits qui different de la premiere cle ont besoin d'etre tries ; l'indice de paquet n'en fait pas
+    // partie : les cles arrivent dans l'ordre de soumission et le tri LSD est stable
+    uint64_t first = m_Keys[0], varying = 0;
+    for (uint64_t key : m_Keys) varying |= key ^ first;
+    varying &= ~SORT_KEY_PACKET_MASK;
+    if (varying == 0) return;
+    int lowBit = SORT_KEY_PACKET_BITS, highBit = 63;
+    while (!(varying >> lowBit & 1)) lowBit++;
+    while (!(varying >> highBit & 1)) highBit--;
+
+    const int maxPasses = (64 + RADIX_BITS - 1) / RADIX_BITS;
+    const uint32_t radixMask = (1u << RADIX_BITS) - 1;
+    int passCount = (highBit - lowBit + RADIX_BITS) / RADIX_BITS;
+
+    // tous les histogrammes en une seule lecture des cles
+    m_Histograms.assign(maxPasses << RADIX_BITS, 0);
+    for (uint64_t key : m_Keys) {
+        uint64_t bits = key >> lowBit;
+        for (int pass = 0; pass < passCount; pass++) m_Histograms[(pass << RADIX_BITS) + ((bits >> (pass * RADIX_BITS)) & radixMask)]++;
+    }
+
+    uint64_t* source = m_Keys.data();
+    uint64_t* destination = m_Scratch.data();
+    for (int pass = 0; pass < passCount; pass++) {
+        uint32_t* histogram = &m_Histograms[pass << RADIX_BITS];
+        int shift = lowBit + pass * RADIX_BITS;
+
+        uint32_t offset = 0;
+        for (uint32_t bucket = 0; bucket <= radixMask; bucket++) {
+            uint32_t bucketCount = histogram[bucket];
+            histogram[bucket] = offset;
+            offset += bucketCount;
+        }
+        for (size_t i = 0; i < count; i++) {
+            destination[histogram[(source[i] >> shift) & radixMask]++] = source[i];
+        }
+        std::swap(source, destination);
+    }
+    if (source != m_Keys.data()) m_Keys.swap(m_Scratch);
+}
+
+void RenderQueue::Execute(const RingBuffer& ring) const {
+    // une passe du GpuProfiler par RenderPass, les paquets d'une passe sont contigus apres le tri
+    static const char* const PASS_NAMES[] = { "opaque", "transparent", "overlay" };
+    uint64_t currentPass = ~0ull;
+
+    // glState elide les changements de programme et de VAO entre paquets voisins
+    for (uint64_t key : m_Keys) {
+        if (key >> 62 != currentPass) {
+            currentPass = key >> 62;
+            gpuProfiler.EndPass();
+            gpuProfiler.BeginPass(PASS_NAMES[currentPass]);
+        }
+        const DrawPacket& packet = m_Packets[key & SORT_KEY_PACKET_MASK];
+        packet.shader->Use();
+        glState.BindVertexArray(packet.vertexArray);
+        if (packet.objectOffset != NO_OBJECT_BLOCK) {
+            glState.BindBufferRange(GL_UNIFORM_BUFFER, OBJECT_BLOCK_BINDING, ring.m_Buffer, packet.objectOffset, sizeof(ObjectBlock));
+        }
+
+        if (packet.indirectBuffer) {
+            // instanceCount n'est connu que du GPU ; count, s'il est renseigne, donne les index effectivement dessines,
+            // sinon (commandes ecrites par le culling GPU) les triangles de la frame sont inconnus
+            glState.BindBuffer(GL_DRAW_INDIRECT_BUFFER, packet.indirectBuffer);
+            glMultiDrawElementsIndirect(packet.mode, packet.indexType, (const void*)packet.indirectOffset, packet.drawCount, 0);
+            if (packet.mode == GL_TRIANGLES) {
+                if (packet.count) frameBenchmark.CountTriangles(packet.count / 3);
+                else frameBenchmark.MarkTrianglesUnknown();
+            }
+        } else {
+            const void* indices = (const void*)((size_t)packet.firstIndex * (packet.indexType == GL_UNSIGNED_SHORT ? 2 : 4));
+            if (packet.instanceCount) {
+                if (!packet.indexType) glDrawArraysInstanced(packet.mode, packet.firstIndex, packet.count, packet.instanceCount);
+                else if (packet.baseInstance) glDrawElementsInstancedBaseInstance(packet.mode, packet.count, packet.indexType, indices, packet.instanceCount, packet.baseInstance);
+                else glDrawElementsInstanced(packet.mode, packet.count, packet.indexType, indices, packet.instanceCount);
+                frameBenchmark.CountInstances(packet.instanceCount);
+            } else {
+                if (packet.indexType) glDrawElements(packet.mode, packet.count, packet.indexType, indices);
+                else glDrawArrays(packet.mode, packet.firstIndex, packet.count);
+            }
+            if (packet.mode == GL_TRIANGLES) frameBenchmark.CountTriangles((uint64_t)(packet.count / 3) * std::max(packet.instanceCount, 1u));
+        }
+        frameBenchmark.CountDrawCall();
+    }
+    gpuProfiler.EndPass();
+}
+
+void RenderQueue::Clear() {
+    m_Packets.clear();
+    m_Keys.clear();
+}
@@ -0,0 +1,69 @@
+#pragma once
+
+#include "GLShader.h"
+#include "RingBuffer.h"
+#include <cstdint>
+#include <cstddef>
+#include <vector>
+
+// passes dans l'ordre d'execution (2 bits de poids fort de la cle)
+enum RenderPass {
+    RENDER_PASS_OPAQUE,
+    RENDER_PASS_TRANSPARENT,
+    RENDER_PASS_OVERLAY
+};
+
+const size_t NO_OBJECT_BLOCK = (size_t)-1;
+
+// tout ce qu'il faut pour un draw ; les pointeurs d'attributs vivent dans le VAO et sont poses a la soumission
+struct DrawPacket {
+    const GLShader* shader;
+    uint32_t vertexArray;
+    uint32_t mode;            // GL_TRIANGLES, GL_LINES...
+    uint32_t count;           // nombre d'index, ou de vertex sans index
+    uint32_t indexType;       // 0 : glDrawArrays
+    uint32_t instanceCount;   // 0 : draw non instancie
+    size_t objectOffset;      // ObjectBlock dans le ring, NO_OBJECT_BLOCK si aucun
+    uint32_t indirectBuffer;  // non nul : glMultiDrawElementsIndirect sur drawCount commandes de ce buffer
+    uint32_t drawCount;
+    uint32_t firstIndex;      // premier index dans l'EBO (plage d'un LOD), ou premier vertex sans index
+    uint32_t baseInstance;    // decalage des attributs a diviseur, GL 4.2 / ARB_base_instance
+    size_t indirectOffset;    // en octets dans indirectBuffer (commandes ecrites dans le ring)
+};
+
+// cle de tri 64 bits, les 20 bits du bas recoivent l'indice du paquet a la soumission :
+//   opaque / overlay : passe(2) | programme(12) | materiau(12) | profondeur(18) | paquet(20), de l'avant vers l'arriere
+//   transparent      : passe(2) | ~profondeur(18) | programme(12) | materiau(12) | paquet(20), de l'arriere vers l'avant
+// programme et materiau sont tronques : une collision ne change que l'ordre, pas le rendu
+const uint32_t SORT_KEY_PACKET_BITS = 20;
+const uint64_t SORT_KEY_PACKET_MASK = (1ull << SORT_KEY_PACKET_BITS) - 1;
+const uint32_t SORT_KEY_PROGRAM_SHIFT = 50;   // position du programme dans une cle opaque
+uint64_t makeSortKey(RenderPass pass, uint32_t program, uint32_t material, float viewDepth);
+
+// paquets soumis pendant la frame, tries par cle puis executes a travers glState
+class RenderQueue {
+public:
+    void Reserve(size_t count);
+    // au-dela de 2^20 paquets par frame la soumission est ignoree
+    void Submit(uint64_t key, const DrawPacket& packet) {
+        if (m_Packets.size() > SORT_KEY_PACKET_MASK) return;
+        m_Keys.push_back(key | m_Packets.size());
+        m_Packets.push_back(packet);
+    }
+
+    // tri par base 2048 (LSD) des cles seules (8 octets), limite aux bits qui varient d'une cle a l'autre
+    void Sort();
+    void Execute(const RingBuffer& ring) const;
+    void Clear();
+
+    size_t GetCount() const { return m_Packets.size(); }
+    uint64_t GetKey(size_t i) const { return m_Keys[i] & ~SORT_KEY_PACKET_MASK; }   // apres Sort, dans l'ordre d'execution
+
+private:
+    static const int RADIX_BITS = 11;
+
+    std::vector<DrawPacket> m_Packets;
+    std::vector<uint64_t> m_Keys;
+    std::vector<uint64_t> m_Scratch;
+    std::vector<uint32_t> m_Histograms;
+};
@@ -0,0 +1,107 @@
+#include "RingBuffer.h"
+#include "GLStateCache.h"
+#include <GL/glew.h>
+#include <GL/gl.h>
+#include <chrono>
+#include <cstring>
+#include <iostream>
+
+RingBuffer::RingBuffer() : m_Buffer(0), m_Mapping(nullptr), m_StagingData(nullptr), m_FrameSize(0), m_Head(0), m_Flushed(0), m_Region(0), m_LastWaitMs(0.0) {}
+
+RingBuffer::~RingBuffer() {
+    Destroy();
+}
+
+bool RingBuffer::Create(size_t frameSize, uint32_t frameCount) {
+    Destroy();
+    m_FrameSize = frameSize;
+    m_Fences.assign(frameCount, nullptr);
+    m_Region = frameCount - 1;   // BeginFrame commence par la region 0
+
+    glGenBuffers(1, &m_Buffer);
+    glState.BindBuffer(GL_COPY_WRITE_BUFFER, m_Buffer);
+    if (GLEW_ARB_buffer_storage) {
+        // coherent : les ecritures CPU sont visibles du GPU sans glFlushMappedBufferRange
+        GLbitfield flags = GL_MAP_WRITE_BIT | GL_MAP_PERSISTENT_BIT | GL_MAP_COHERENT_BIT;
+        glBufferStorage(GL_COPY_WRITE_BUFFER, frameSize * frameCount, nullptr, flags);
+        m_Mapping = (uint8_t*)glMapBufferRange(GL_COPY_WRITE_BUFFER, 0, frameSize * frameCount, flags);
+        if (!m_Mapping) {
+            std::cerr << "Echec du mapping persistant du ring buffer" << std::endl;
+            return false;
+        }
+    } else {
+        glBufferData(GL_COPY_WRITE_BUFFER, frameSize * frameCount, nullptr, GL_STREAM_DRAW);
+        // les Mat4 alignees ecrites dans le ring exigent le meme alignement qu'un mapping (64 octets)
+        m_Staging.resize(frameSize + 64);
+        m_StagingData = m_Staging.data() + (64 - (uintptr_t)m_Staging.data() % 64) % 64;
+    }
+    return m_Buffer != 0;
+}
+
+void RingBuffer::Destroy() {
+    for (void* fence : m_Fences) {
+        if (fence) glDeleteSync((GLsync)fence);
+    }
+    m_Fences.clear();
+    if (m_Buffer) {
+        if (m_Mapping) {
+            glState.BindBuffer(GL_COPY_WRITE_BUFFER, m_Buffer);
+            glUnmapBuffer(GL_COPY_WRITE_BUFFER);
+        }
+        glState.ForgetBuffer(m_Buffer);
+        glDeleteBuffers(1, &m_Buffer);
+        m_Buffer = 0;
+    }
+    m_Mapping = nullptr;
+    m_Staging.clear();
+    m_StagingData = nullptr;
+    m_FrameSize = 0;
+}
+
+void RingBuffer::BeginFrame() {
+    m_Region = (m_Region + 1) % (uint32_t)m_Fences.size();
+    m_Head = 0;
+    m_Flushed = 0;
+    m_LastWaitMs = 0.0;
+
+    // en regime permanent la fence est deja signalee et l'attente est nulle
+    GLsync fence = (GLsync)m_Fences[m_Region];
+    if (fence) {
+        auto start = std::chrono::steady_clock::now();
+        glClientWaitSync(fence, GL_SYNC_FLUSH_COMMANDS_BIT, GL_TIMEOUT_IGNORED);
+        std::chrono::duration<double, std::milli> elapsed = std::chrono::steady_clock::now() - start;
+        m_LastWaitMs = elapsed.count();
+        glDeleteSync(fence);
+        m_Fences[m_Region] = nullptr;
+    }
+}
+
+void RingBuffer::EndFrame() {
+    Flush();
+    m_Fences[m_Region] = glFenceSync(GL_SYNC_GPU_COMMANDS_COMPLETE, 0);
+}
+
+RingAllocation RingBuffer::Allocate(size_t size, size_t alignment) {
+    RingAllocation allocation;
+    size_t start = (m_Head + alignment - 1) / alignment * alignment;
+    if (start + size > m_FrameSize) {
+        std::cerr << "Ring buffer plein (" << m_FrameSize << " octets par frame)" << std::endl;
+        return allocation;
+    }
+    m_Head = start + size;
+
+    allocation.offset = m_Region * m_FrameSize + start;
+    allocation.data = m_Mapping ? m_Mapping + allocation.offset : m_StagingData + start;
+    return allocation;
+}
+
+void RingBuffer::Flush() {
+    if (m_Mapping || m_Head == m_Flushed) return;
+    glState.BindBuffer(GL_COPY_WRITE_BUFFER, m_Buffer);
+    glBufferSubData(GL_COPY_WRITE_BUFFER, m_Region * m_FrameSize + m_Flushed, m_Head - m_Flushed, m_StagingData + m_Flushed);
+    m_Flushed = m_Head;
+}
+
+void RingBuffer::BindUniform(uint32_t binding, const RingAllocation& allocation, size_t size) const {
+    glState.BindBufferRange(GL_UNIFORM_BUFFER, binding, m_Buffer, allocation.offset, size);
+}
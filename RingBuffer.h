@@ -0,0 +1,52 @@
+#pragma once
+
+#include <cstdint>
+#include <cstddef>
+#include <vector>
+
+// bloc suballoue dans le ring pour la frame courante
+struct RingAllocation {
+    void* data = nullptr;   // ou ecrire cote CPU (nullptr si le ring est plein)
+    size_t offset = 0;      // offset dans le buffer GL, a passer aux binds / pointeurs d'attributs
+};
+
+// buffer unique decoupe en une region par frame en vol (triple buffering)
+// avec ARB_buffer_storage la memoire est mappee une fois pour toutes et chaque region
+// est protegee par une fence : on ne reecrit une region qu'apres que le GPU l'a lue
+class RingBuffer {
+public:
+    uint32_t m_Buffer;
+
+    RingBuffer();
+    ~RingBuffer();
+
+    bool Create(size_t frameSize, uint32_t frameCount = 3);
+    void Destroy();
+
+    // passe a la region suivante en attendant sa fence, puis la pose a la fin de la frame
+    void BeginFrame();
+    void EndFrame();
+
+    RingAllocation Allocate(size_t size, size_t alignment);
+
+    // sans stockage persistant : envoie ce qui a ete ecrit depuis le dernier Flush (a appeler avant les draws)
+    void Flush();
+
+    // lie une allocation a un point de liaison de bloc uniforme
+    void BindUniform(uint32_t binding, const RingAllocation& allocation, size_t size) const;
+
+    bool IsPersistent() const { return m_Mapping != nullptr; }
+    size_t GetFrameSize() const { return m_FrameSize; }
+    double GetLastWaitMs() const { return m_LastWaitMs; }   // attente CPU de la derniere BeginFrame
+
+private:
+    uint8_t* m_Mapping;              // memoire mappee en permanence
+    std::vector<uint8_t> m_Staging;  // copie CPU de la region courante sans ARB_buffer_storage
+    uint8_t* m_StagingData;          // debut de m_Staging aligne comme un mapping GL
+    std::vector<void*> m_Fences;     // GLsync par region
+    size_t m_FrameSize;
+    size_t m_Head;                   // prochain octet libre dans la region courante
+    size_t m_Flushed;                // partie de la region deja envoyee (chemin non persistant)
+    uint32_t m_Region;
+    double m_LastWaitMs;
+};
@@ -0,0 +1,124 @@
+#include "ShaderCache.h"
+#include <GL/glew.h>
+#include <GL/gl.h>
+#include <cstdio>
+#include <cstring>
+#include <fstream>
+#include <iostream>
+#include <filesystem>
+#include <vector>
+
+ShaderCache shaderCache;
+
+const uint32_t SHADER_CACHE_MAGIC = 0x42505347; // "GSPB"
+const uint32_t SHADER_CACHE_VERSION = 1;
+
+// en-tete de chaque fichier du cache, suivi du binaire
+struct ShaderCacheHeader {
+    uint32_t magic;
+    uint32_t version;
+    uint64_t key;
+    uint32_t format;   // binaryFormat renvoye par glGetProgramBinary
+    uint32_t length;
+};
+
+// FNV-1a 64 bits
+static uint64_t hashString(uint64_t hash, const char* data, size_t size) {
+    for (size_t i = 0; i < size; i++) {
+        hash ^= (uint8_t)data[i];
+        hash *= 1099511628211ull;
+    }
+    // separateur pour que ("ab", "c") et ("a", "bc") different
+    hash ^= 0xFF;
+    return hash * 1099511628211ull;
+}
+
+ShaderCache::ShaderCache() : m_Directory("shadercache"), m_Enabled(true), m_Hits(0), m_Misses(0) {}
+
+bool ShaderCache::IsAvailable() const {
+    if (!m_Enabled || !GLEW_ARB_get_program_binary) return false;
+    GLint formats = 0;
+    glGetIntegerv(GL_NUM_PROGRAM_BINARY_FORMATS, &formats);
+    return formats > 0;
+}
+
+uint64_t ShaderCache::MakeKey(const std::string& vertexCode, const std::string& fragmentCode) const {
+    uint64_t hash = 14695981039346656037ull;
+    for (GLenum name : { GL_VENDOR, GL_RENDERER, GL_VERSION }) {
+        const char* value = (const char*)glGetString(name);
+        if (value) hash = hashString(hash, value, strlen(value));
+    }
+    hash = hashString(hash, vertexCode.data(), vertexCode.size());
+    return hashString(hash, fragmentCode.data(), fragmentCode.size());
+}
+
+std::string ShaderCache::GetPath(uint64_t key) const {
+    char name[32];
+    snprintf(name, sizeof(name), "%016llx.bin", (unsigned long long)key);
+    return m_Directory + "/" + name;
+}
+
+uint32_t ShaderCache::Load(uint64_t key) {
+    if (!IsAvailable()) return 0;
+
+    std::ifstream file(GetPath(key), std::ios::binary);
+    ShaderCacheHeader header = {};
+    if (!file.is_open() || !file.read((char*)&header, sizeof(header)) ||
+        header.magic != SHADER_CACHE_MAGIC || header.version != SHADER_CACHE_VERSION || header.key != key) {
+        m_Misses++;
+        return 0;
+    }
+    // longueur corrompue : ne pas allouer plus que ce qui reste dans le fichier
+    std::streamoff start = file.tellg();
+    file.seekg(0, std::ios::end);
+    std::streamoff remaining = file.tellg() - start;
+    file.seekg(start);
+    if (start < 0 || (std::streamoff)header.length > remaining) {
+        m_Misses++;
+        return 0;
+    }
+    std::vector<char> binary(header.length);
+    if (!file.read(binary.data(), binary.size())) {
+        m_Misses++;
+        return 0;
+    }
+
+    // le driver peut refuser un binaire (mise a jour, autre GPU) : on recompilera
+    GLuint program = glCreateProgram();
+    glProgramBinary(program, header.format, binary.data(), header.length);
+    GLint success = 0;
+    glGetProgramiv(program, GL_LINK_STATUS, &success);
+    if (!success) {
+        glDeleteProgram(program);
+        m_Misses++;
+        return 0;
+    }
+    m_Hits++;
+    return program;
+}
+
+void ShaderCache::Store(uint64_t key, uint32_t program) {
+    if (!IsAvailable()) return;
+
+    GLint length = 0;
+    glGetProgramiv(program, GL_PROGRAM_BINARY_LENGTH, &length);
+    if (length <= 0) return;
+
+    ShaderCacheHeader header = { SHADER_CACHE_MAGIC, SHADER_CACHE_VERSION, key, 0, 0 };
+    std::vector<char> binary(length);
+    GLsizei written = 0;
+    GLenum format = 0;
+    glGetProgramBinary(program, length, &written, &format, binary.data());
+    header.format = format;
+    header.length = (uint32_t)written;
+
+    std::error_code error;
+    std::filesystem::create_directories(m_Directory, error);
+    std::ofstream file(GetPath(key), std::ios::binary | std::ios::trunc);
+    if (!file.is_open()) {
+        std::cerr << "Impossible d'ecrire le cache de shaders dans " << m_Directory << std::endl;
+        return;
+    }
+    file.write((const char*)&header, sizeof(header));
+    file.write(binary.data(), written);
+}
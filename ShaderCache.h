@@ -0,0 +1,37 @@
+#pragma once
+
+#include <cstdint>
+#include <string>
+
+// cache disque des binaires de programmes (glGetProgramBinary / glProgramBinary)
+// la cle couvre les sources pretraitees et le driver : un changement de l'un ou de l'autre
+// donne une autre cle, et un binaire refuse par le driver est simplement recompile
+class ShaderCache {
+public:
+    ShaderCache();
+
+    void SetDirectory(const std::string& directory) { m_Directory = directory; }
+    void SetEnabled(bool enabled) { m_Enabled = enabled; }
+    bool IsAvailable() const;   // active et supporte par le contexte courant
+
+    uint64_t MakeKey(const std::string& vertexCode, const std::string& fragmentCode) const;
+
+    // programme lie depuis le binaire en cache, 0 si absent ou refuse
+    uint32_t Load(uint64_t key);
+    // a appeler apres une edition de liens avec GL_PROGRAM_BINARY_RETRIEVABLE_HINT
+    void Store(uint64_t key, uint32_t program);
+
+    uint32_t GetHits() const { return m_Hits; }
+    uint32_t GetMisses() const { return m_Misses; }
+
+private:
+    std::string m_Directory;
+    bool m_Enabled;
+    uint32_t m_Hits;
+    uint32_t m_Misses;
+
+    std::string GetPath(uint64_t key) const;
+};
+
+// instance globale utilisee par GLShader::LoadShaders
+extern ShaderCache shaderCache;
@@ -0,0 +1,147 @@
+#include "ShaderCompiler.h"
+#include "Profiler.h"
+#include <GL/glew.h>
+#include <GLFW/glfw3.h>
+#include <iostream>
+
+ShaderCompiler::ShaderCompiler() : m_Mode(SHADER_COMPILE_SYNC), m_WorkerWindow(nullptr), m_Running(false) {}
+
+ShaderCompiler::~ShaderCompiler() {
+    Shutdown();
+}
+
+void ShaderCompiler::Initialize(GLFWwindow* mainWindow, ShaderCompileMode requested) {
+    m_Mode = SHADER_COMPILE_SYNC;
+
+    if (requested == SHADER_COMPILE_PARALLEL && GLEW_KHR_parallel_shader_compile) {
+        // 0xFFFFFFFF : autant de threads que le driver le juge utile
+        glMaxShaderCompilerThreadsKHR(0xFFFFFFFF);
+        m_Mode = SHADER_COMPILE_PARALLEL;
+        return;
+    }
+
+    if (requested != SHADER_COMPILE_SYNC) {
+        // fenetre invisible dont le contexte partage les objets du contexte principal
+        glfwWindowHint(GLFW_VISIBLE, GLFW_FALSE);
+        m_WorkerWindow = glfwCreateWindow(1, 1, "shader compiler", nullptr, mainWindow);
+        glfwMakeContextCurrent(mainWindow);
+        if (!m_WorkerWindow) {
+            std::cerr << "Contexte de compilation indisponible, compilation synchrone" << std::endl;
+            return;
+        }
+        m_Running = true;
+        m_Worker = std::thread(&ShaderCompiler::WorkerLoop, this);
+        m_Mode = SHADER_COMPILE_WORKER;
+    }
+}
+
+void ShaderCompiler::Shutdown() {
+    if (m_Worker.joinable()) {
+        {
+            std::lock_guard<std::mutex> lock(m_Mutex);
+            m_Running = false;
+        }
+        m_Wake.notify_all();
+        m_Worker.join();
+    }
+    if (m_WorkerWindow) {
+        glfwDestroyWindow(m_WorkerWindow);
+        m_WorkerWindow = nullptr;
+    }
+    m_Queue.clear();
+    m_Requests.clear();
+}
+
+void ShaderCompiler::Submit(GLShader& shader, const char* vertexPath, const char* fragmentPath, const std::string& defines) {
+    m_Requests.push_back(std::make_unique<Request>());
+    Request& request = *m_Requests.back();
+    request.shader = &shader;
+    request.vertexPath = vertexPath;
+    request.fragmentPath = fragmentPath;
+    request.defines = defines;
+    request.compiled = false;
+    request.submitted = false;
+
+    if (m_Mode == SHADER_COMPILE_WORKER) {
+        {
+            std::lock_guard<std::mutex> lock(m_Mutex);
+            m_Queue.push_back(&request);
+        }
+        m_Wake.notify_one();
+        return;
+    }
+
+    // mode synchrone ou parallele : les appels GL se font sur le contexte principal
+    request.submitted = shader.Compile(vertexPath, fragmentPath, defines);
+    request.compiled = true;
+}
+
+bool ShaderCompiler::IsReady(const Request& request) const {
+    return request.compiled && (!request.submitted || request.shader->IsCompiled());
+}
+
+size_t ShaderCompiler::GetPendingCount() {
+    size_t pending = 0;
+    for (const std::unique_ptr<Request>& request : m_Requests) {
+        if (!IsReady(*request)) pending++;
+    }
+    return pending;
+}
+
+void ShaderCompiler::FinishReady(std::vector<GLShader*>& finished, std::vector<GLShader*>& failed) {
+    for (size_t i = 0; i < m_Requests.size();) {
+        Request& request = *m_Requests[i];
+        if (!IsReady(request)) {
+            i++;
+            continue;
+        }
+        if (request.submitted && request.shader->Finish()) {
+            finished.push_back(request.shader);
+        } else {
+            failed.push_back(request.shader);
+        }
+        m_Requests.erase(m_Requests.begin() + i);
+    }
+}
+
+bool ShaderCompiler::WaitAll() {
+    bool success = true;
+    for (const std::unique_ptr<Request>& request : m_Requests) {
+        while (!request->compiled) std::this_thread::yield();
+        if (!request->submitted || !request->shader->Finish()) {
+            std::cerr << "Echec du programme " << request->vertexPath << " / " << request->fragmentPath << std::endl;
+            success = false;
+        }
+    }
+    m_Requests.clear();
+    return success;
+}
+
+const char* ShaderCompiler::GetModeName() const {
+    switch (m_Mode) {
+    case SHADER_COMPILE_PARALLEL: return "GL_KHR_parallel_shader_compile";
+    case SHADER_COMPILE_WORKER: return "contexte partage";
+    default: return "synchrone";
+    }
+}
+
+void ShaderCompiler::WorkerLoop() {
+    PROFILE_THREAD_NAME("shader compiler");
+    glfwMakeContextCurrent(m_WorkerWindow);
+    while (true) {
+        Request* request = nullptr;
+        {
+            std::unique_lock<std::mutex> lock(m_Mutex);
+            m_Wake.wait(lock, [this] { return !m_Running || !m_Queue.empty(); });
+            if (!m_Running) break;
+            request = m_Queue.front();
+            m_Queue.pop_front();
+        }
+
+        request->submitted = request->shader->Compile(request->vertexPath.c_str(), request->fragmentPath.c_str(), request->defines);
+        // les objets ne sont utilisables depuis le contexte principal qu'une fois le travail termine
+        glFinish();
+        request->compiled = true;
+    }
+    glfwMakeContextCurrent(nullptr);
+}
@@ -0,0 +1,67 @@
+#pragma once
+
+#include "GLShader.h"
+#include <atomic>
+#include <condition_variable>
+#include <deque>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+struct GLFWwindow;
+
+// mode de compilation asynchrone retenu selon les capacites du contexte
+enum ShaderCompileMode {
+    SHADER_COMPILE_SYNC,       // compilation bloquante au moment du Submit
+    SHADER_COMPILE_PARALLEL,   // GL_KHR_parallel_shader_compile, le driver compile en arriere-plan
+    SHADER_COMPILE_WORKER      // contexte partage sur un thread dedie
+};
+
+// soumet de nombreux programmes sans bloquer puis attend qu'ils soient prets,
+// ce qui laisse le thread principal charger les autres ressources pendant ce temps
+class ShaderCompiler {
+public:
+    ShaderCompiler();
+    ~ShaderCompiler();
+
+    // choisit le mode (celui demande s'il est disponible) ; a appeler avec le contexte principal courant
+    void Initialize(GLFWwindow* mainWindow, ShaderCompileMode requested);
+    void Shutdown();
+
+    void Submit(GLShader& shader, const char* vertexPath, const char* fragmentPath, const std::string& defines = "");
+
+    size_t GetPendingCount();   // programmes pas encore prets, sans bloquer
+    bool WaitAll();             // termine tous les programmes soumis, false si l'un d'eux a echoue
+
+    // termine seulement les programmes deja prets, sans bloquer ; les echecs vont dans failed
+    void FinishReady(std::vector<GLShader*>& finished, std::vector<GLShader*>& failed);
+
+    ShaderCompileMode GetMode() const { return m_Mode; }
+    const char* GetModeName() const;
+
+private:
+    struct Request {
+        GLShader* shader;
+        std::string vertexPath;
+        std::string fragmentPath;
+        std::string defines;
+        std::atomic<bool> compiled;   // soumis au driver et termine (mode worker)
+        bool submitted;               // Compile a reussi
+    };
+
+    ShaderCompileMode m_Mode;
+    std::vector<std::unique_ptr<Request>> m_Requests;
+
+    // mode worker
+    GLFWwindow* m_WorkerWindow;
+    std::thread m_Worker;
+    std::mutex m_Mutex;
+    std::condition_variable m_Wake;
+    std::deque<Request*> m_Queue;
+    bool m_Running;
+
+    void WorkerLoop();
+    bool IsReady(const Request& request) const;
+};
@@ -0,0 +1,137 @@
+#include "ShaderLibrary.h"
+#include <algorithm>
+#include <iostream>
+
+struct ShaderProgramDesc {
+    const char* name;
+    const char* vertexPath;
+    const char* fragmentPath;
+    uint32_t features;
+};
+
+static const ShaderProgramDesc shaderPrograms[SHADER_PROGRAM_COUNT] = {
+    { "Basic", "Basic.vs", "Basic.fs", SHADER_FEATURE_INSTANCED },
+    { "Mesh", "Mesh.vs", "Mesh.fs", SHADER_FEATURE_INSTANCED | SHADER_FEATURE_QUANTIZED | SHADER_FEATURE_BLINN_PHONG },
+    { "Debug", "Debug.vs", "Debug.fs", 0 },
+    { "Cull", "Cull.cs", "", 0 },
+    { "ClusterCull", "ClusterCull.cs", "", 0 },
+};
+
+static const char* featureNames[SHADER_FEATURE_COUNT] = { "INSTANCED", "QUANTIZED", "BLINN_PHONG" };
+
+void ShaderLibrary::Shutdown() {
+    m_Compiler.Shutdown();
+    m_Reloads.clear();
+    m_Variants.clear();
+    m_BlockBindings.clear();
+}
+
+void ShaderLibrary::SubmitVariant(uint64_t key, GLShader& shader) {
+    const ShaderProgramDesc& desc = shaderPrograms[key >> 32];
+    m_Compiler.Submit(shader, desc.vertexPath, desc.fragmentPath, GetDefines((uint32_t)key));
+}
+
+GLShader* ShaderLibrary::Request(const Material& material) {
+    // une option non geree par le programme donnerait un doublon de la meme variante
+    uint32_t features = material.features & GetSupportedFeatures(material.program);
+    uint64_t key = (uint64_t)material.program << 32 | features;
+
+    auto it = m_Variants.find(key);
+    if (it != m_Variants.end()) return it->second.get();
+
+    std::unique_ptr<GLShader>& variant = m_Variants[key];
+    variant = std::make_unique<GLShader>();
+    SubmitVariant(key, *variant);
+    return variant.get();
+}
+
+void ShaderLibrary::BindUniformBlock(const char* name, uint32_t binding) {
+    m_BlockBindings.push_back({ name, binding });
+    for (const auto& variant : m_Variants) {
+        if (variant.second->GetProgram()) variant.second->BindUniformBlock(name, binding);
+    }
+}
+
+void ShaderLibrary::Reload(const std::vector<std::string>& changedFiles) {
+    for (const auto& variant : m_Variants) {
+        bool affected = std::any_of(changedFiles.begin(), changedFiles.end(),
+            [&](const std::string& file) { return variant.second->DependsOn(file); });
+        if (!affected) continue;
+
+        // la compilation en cours ne peut pas etre annulee, elle sera relancee a sa fin
+        auto pending = m_Reloads.find(variant.first);
+        if (pending != m_Reloads.end()) {
+            pending->second.stale = true;
+            continue;
+        }
+        PendingReload& reload = m_Reloads[variant.first];
+        reload.shader = std::make_unique<GLShader>();
+        reload.stale = false;
+        SubmitVariant(variant.first, *reload.shader);
+    }
+}
+
+size_t ShaderLibrary::SwapReloaded() {
+    if (m_Reloads.empty()) return 0;
+
+    std::vector<GLShader*> finished, failed;
+    m_Compiler.FinishReady(finished, failed);
+    finished.insert(finished.end(), failed.begin(), failed.end());
+
+    size_t swapped = 0;
+    for (size_t i = 0; i < finished.size(); i++) {
+        auto reload = std::find_if(m_Reloads.begin(), m_Reloads.end(),
+            [&](const std::pair<const uint64_t, PendingReload>& entry) { return entry.second.shader.get() == finished[i]; });
+        if (reload == m_Reloads.end()) continue;
+
+        uint64_t key = reload->first;
+        Material material = { (ShaderProgramId)(key >> 32), (uint32_t)key };
+        if (reload->second.stale) {
+            reload->second.shader = std::make_unique<GLShader>();
+            reload->second.stale = false;
+            SubmitVariant(key, *reload->second.shader);
+            continue;
+        }
+
+        if (i < finished.size() - failed.size()) {
+            GLShader& replacement = *reload->second.shader;
+            for (const auto& block : m_BlockBindings) replacement.BindUniformBlock(block.first, block.second);
+            m_Variants[key]->Swap(replacement);
+            std::cout << "Shader recharge : " << GetVariantName(material) << std::endl;
+            swapped++;
+        } else {
+            std::cerr << "Rechargement de " << GetVariantName(material) << " echoue, ancienne version conservee" << std::endl;
+        }
+        m_Reloads.erase(reload);
+    }
+    return swapped;
+}
+
+void ShaderLibrary::GetSourceFiles(std::vector<std::string>& files) const {
+    for (const auto& variant : m_Variants) {
+        for (const std::string& file : variant.second->GetSourceFiles()) {
+            if (std::find(files.begin(), files.end(), file) == files.end()) files.push_back(file);
+        }
+    }
+}
+
+uint32_t ShaderLibrary::GetSupportedFeatures(ShaderProgramId program) {
+    return shaderPrograms[program].features;
+}
+
+std::string ShaderLibrary::GetDefines(uint32_t features) {
+    std::string defines;
+    for (uint32_t bit = 0; bit < SHADER_FEATURE_COUNT; bit++) {
+        if (features & (1u << bit)) defines += std::string("#define ") + featureNames[bit] + "\n";
+    }
+    return defines;
+}
+
+std::string ShaderLibrary::GetVariantName(const Material& material) {
+    std::string name = shaderPrograms[material.program].name;
+    uint32_t features = material.features & GetSupportedFeatures(material.program);
+    for (uint32_t bit = 0; bit < SHADER_FEATURE_COUNT; bit++) {
+        if (features & (1u << bit)) name += std::string("+") + featureNames[bit];
+    }
+    return name;
+}
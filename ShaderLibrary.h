@@ -0,0 +1,75 @@
+#pragma once
+
+#include "GLShader.h"
+#include "ShaderCompiler.h"
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+// programmes sources (une paire .vs/.fs chacun, ou un compute shader .cs)
+enum ShaderProgramId {
+    SHADER_BASIC,    // cube colore par vertex
+    SHADER_MESH,     // mesh eclaire
+    SHADER_DEBUG,    // lignes de debug
+    SHADER_CULL,     // culling des instances sur GPU (compute)
+    SHADER_CLUSTER_CULL,   // culling des clusters du dragon sur GPU (compute)
+    SHADER_PROGRAM_COUNT
+};
+
+// options de compilation (bits), chacune devient un #define dans les sources
+const uint32_t SHADER_FEATURE_INSTANCED = 1 << 0;     // matrice model en attribut par instance
+const uint32_t SHADER_FEATURE_QUANTIZED = 1 << 1;     // vertex compresses 16 octets
+const uint32_t SHADER_FEATURE_BLINN_PHONG = 1 << 2;   // speculaire en plus du diffus
+const uint32_t SHADER_FEATURE_COUNT = 3;
+
+// programme et options demandes par un objet : une variante specialisee, sans branche dans le shader
+struct Material {
+    ShaderProgramId program;
+    uint32_t features;
+};
+
+// cache memoire des variantes compilees, cle (programme, options)
+// une variante est soumise au ShaderCompiler a sa premiere demande puis reutilisee
+class ShaderLibrary {
+public:
+    void Initialize(GLFWwindow* mainWindow, ShaderCompileMode mode) { m_Compiler.Initialize(mainWindow, mode); }
+    void Shutdown();
+
+    GLShader* Request(const Material& material);
+    size_t GetPendingCount() { return m_Compiler.GetPendingCount(); }
+    bool WaitAll() { return m_Compiler.WaitAll(); }
+
+    // a appeler apres WaitAll, applique le point de liaison a toutes les variantes (et a leurs rechargements)
+    void BindUniformBlock(const char* name, uint32_t binding);
+
+    // rechargement a chaud : recompile en arriere-plan les variantes qui dependent de ces fichiers
+    void Reload(const std::vector<std::string>& changedFiles);
+    // entre deux frames : remplace les variantes recompilees, garde l'ancienne si la compilation echoue
+    // retourne le nombre de variantes remplacees
+    size_t SwapReloaded();
+    void GetSourceFiles(std::vector<std::string>& files) const;
+
+    size_t GetVariantCount() const { return m_Variants.size(); }
+    const char* GetCompileModeName() const { return m_Compiler.GetModeName(); }
+
+    // options reellement utilisees par un programme (les autres ne creent pas de variante)
+    static uint32_t GetSupportedFeatures(ShaderProgramId program);
+    static std::string GetDefines(uint32_t features);
+    static std::string GetVariantName(const Material& material);   // "Mesh+QUANTIZED+INSTANCED"
+
+private:
+    ShaderCompiler m_Compiler;
+    std::unordered_map<uint64_t, std::unique_ptr<GLShader>> m_Variants;
+    std::vector<std::pair<std::string, uint32_t>> m_BlockBindings;
+
+    struct PendingReload {
+        std::unique_ptr<GLShader> shader;
+        bool stale;   // fichier modifie de nouveau pendant la compilation
+    };
+    std::unordered_map<uint64_t, PendingReload> m_Reloads;
+
+    void SubmitVariant(uint64_t key, GLShader& shader);
+};
@@ -0,0 +1,86 @@
+#include "ShaderPreprocessor.h"
+#include <algorithm>
+#include <fstream>
+#include <iostream>
+#include <sstream>
+
+const int MAX_INCLUDE_DEPTH = 16;
+
+bool ShaderPreprocessor::ReadFile(const std::string& path, std::string& content) {
+    std::ifstream file(path, std::ios::in);
+    if (!file.is_open()) {
+        std::cerr << "Failed to open shader file: " << path << std::endl;
+        return false;
+    }
+    content.assign((std::istreambuf_iterator<char>(file)), std::istreambuf_iterator<char>());
+    return true;
+}
+
+bool ShaderPreprocessor::Process(const char* path, const std::string& defines, std::string& output) {
+    m_Files.clear();
+    output.clear();
+
+    std::string source;
+    if (!ReadFile(path, source)) return false;
+    m_Files.push_back(path);
+
+    // #version doit rester la premiere directive, les options viennent juste apres
+    size_t bodyStart = 0;
+    int bodyLine = 1;
+    if (source.compare(0, 8, "#version") == 0) {
+        bodyStart = source.find('\n');
+        bodyStart = bodyStart == std::string::npos ? source.size() : bodyStart + 1;
+        output = source.substr(0, bodyStart);
+        bodyLine = 2;
+    }
+    output += defines;
+    output += "#line " + std::to_string(bodyLine) + " 0\n";
+
+    return AppendLines(source.substr(bodyStart), 0, bodyLine, output, 0);
+}
+
+bool ShaderPreprocessor::Include(const std::string& path, std::string& output, int depth) {
+    if (depth > MAX_INCLUDE_DEPTH) {
+        std::cerr << "Trop d'#include imbriques : " << path << std::endl;
+        return false;
+    }
+    // chaque fichier n'est inclus qu'une fois (equivalent de #pragma once)
+    if (std::find(m_Files.begin(), m_Files.end(), path) != m_Files.end()) return true;
+
+    std::string source;
+    if (!ReadFile(path, source)) return false;
+    int fileIndex = (int)m_Files.size();
+    m_Files.push_back(path);
+
+    output += "#line 1 " + std::to_string(fileIndex) + "\n";
+    return AppendLines(source, fileIndex, 1, output, depth);
+}
+
+bool ShaderPreprocessor::AppendLines(const std::string& source, int fileIndex, int firstLine, std::string& output, int depth) {
+    // les #include sont relatifs au dossier du fichier courant
+    std::string path = m_Files[fileIndex];   // copie : les #include imbriques agrandissent m_Files
+    size_t slash = path.find_last_of("/\\");
+    std::string directory = slash == std::string::npos ? "" : path.substr(0, slash + 1);
+
+    std::istringstream input(source);
+    std::string line;
+    for (int lineNumber = firstLine; std::getline(input, line); lineNumber++) {
+        size_t start = line.find_first_not_of(" \t");
+        if (start == std::string::npos || line.compare(start, 8, "#include") != 0) {
+            output += line;
+            output += '\n';
+            continue;
+        }
+
+        size_t open = line.find('"', start);
+        size_t close = open == std::string::npos ? open : line.find('"', open + 1);
+        if (close == std::string::npos) {
+            std::cerr << path << ":" << lineNumber << " : #include mal forme" << std::endl;
+            return false;
+        }
+        if (!Include(directory + line.substr(open + 1, close - open - 1), output, depth + 1)) return false;
+        // retour dans le fichier courant, a la ligne qui suit l'#include
+        output += "#line " + std::to_string(lineNumber + 1) + " " + std::to_string(fileIndex) + "\n";
+    }
+    return true;
+}
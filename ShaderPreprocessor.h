@@ -0,0 +1,23 @@
+#pragma once
+
+#include <string>
+#include <vector>
+
+// pretraitement des sources GLSL avant compilation :
+// - #include "fichier" resolu recursivement, relatif au fichier qui l'inclut, une seule fois par fichier
+// - #define des options injectes juste apres #version
+// - directives #line pour que les erreurs du driver pointent sur le bon fichier et la bonne ligne
+class ShaderPreprocessor {
+public:
+    bool Process(const char* path, const std::string& defines, std::string& output);
+
+    // fichiers lus, l'index est le numero de source des directives #line
+    const std::vector<std::string>& GetFiles() const { return m_Files; }
+
+private:
+    std::vector<std::string> m_Files;
+
+    bool Include(const std::string& path, std::string& output, int depth);
+    bool AppendLines(const std::string& source, int fileIndex, int firstLine, std::string& output, int depth);
+    static bool ReadFile(const std::string& path, std::string& content);
+};
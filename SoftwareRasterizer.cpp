@@ -0,0 +1,479 @@
+#include "SoftwareRasterizer.h"
+#include "Profiler.h"
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstring>
+
+#if defined(MATH_SIMD_SSE)
+#include <immintrin.h>
+#elif defined(MATH_SIMD_NEON)
+#include <arm_neon.h>
+#endif
+
+using Clock = std::chrono::steady_clock;
+
+static const size_t RASTER_VERTEX_GRAIN = 1024;
+static const int32_t RASTER_SUBPIXEL = 1 << RASTER_SUBPIXEL_BITS;
+
+// direction de la lumiere et albedo de Mesh.fs / Lighting.glsl, evalues par vertex (Gouraud)
+static const float LIGHT_DIR[3] = { 0.4f, 0.8f, 0.45f };
+
+// nombre de bits a 1 d'un masque de 4 pixels
+static const uint8_t LANE_COUNT[16] = { 0, 1, 1, 2, 1, 2, 2, 3, 1, 2, 2, 3, 2, 3, 3, 4 };
+
+static int32_t floorDiv(int32_t a, int32_t b) {
+    int32_t q = a / b;
+    return q * b > a ? q - 1 : q;
+}
+
+SoftwareRasterizer::SoftwareRasterizer() : m_Width(0), m_Height(0), m_Stride(0), m_TilesX(0), m_TilesY(0), m_BinCount(0), m_Stats() {}
+
+bool SoftwareRasterizer::Create(uint32_t width, uint32_t height) {
+    if (width == 0 || height == 0 || width > RASTER_MAX_SIZE || height > RASTER_MAX_SIZE) return false;
+    m_Width = width;
+    m_Height = height;
+    m_Stride = (width + 3) & ~3u;
+    m_TilesX = (width + RASTER_TILE_SIZE - 1) / RASTER_TILE_SIZE;
+    m_TilesY = (height + RASTER_TILE_SIZE - 1) / RASTER_TILE_SIZE;
+    m_Color.assign((size_t)m_Stride * height, 0);
+    m_Depth.assign((size_t)m_Stride * height, 1.0f);
+    m_Bins.clear();
+    m_BinCount = 0;
+    m_TileTested.assign(m_TilesX * m_TilesY, 0);
+    m_TileWritten.assign(m_TilesX * m_TilesY, 0);
+    return true;
+}
+
+void SoftwareRasterizer::Clear(uint32_t color) {
+    std::fill(m_Color.begin(), m_Color.end(), color);
+    std::fill(m_Depth.begin(), m_Depth.end(), 1.0f);
+}
+
+void SoftwareRasterizer::DrawMesh(JobSystem& jobs, const MeshFile& mesh, uint32_t firstIndex, uint32_t indexCount, const Mat4& model, const Mat4& viewProjection) {
+    const MeshFileHeader& header = mesh.GetHeader();
+    Clock::time_point start = Clock::now();
+
+    // etage vertex : tous les vertex du fichier, les LOD partagent le meme bloc
+    Mat4 modelViewProjection = multiplyMat4(model, viewProjection);
+    m_Vertices.resize(header.vertexCount);
+    jobs.ParallelFor(header.vertexCount, RASTER_VERTEX_GRAIN, [&](size_t begin, size_t end) {
+        PROFILE_SCOPE("raster vertices");
+        ShadeVertices(mesh, model, modelViewProjection, begin, end);
+    });
+    Clock::time_point shaded = Clock::now();
+
+    // preparation : chaque job remplit son propre lot, les tuiles les relisent dans l'ordre de soumission
+    uint32_t triangleCount = indexCount / 3;
+    m_BinCount = (triangleCount + RASTER_BIN_TRIANGLES - 1) / RASTER_BIN_TRIANGLES;
+    if (m_Bins.size() < m_BinCount) {
+        m_Bins.resize(m_BinCount);
+        for (Bin& bin : m_Bins) bin.tiles.resize(m_TilesX * m_TilesY);
+    }
+    jobs.ParallelFor(m_BinCount, 1, [&](size_t begin, size_t end) {
+        PROFILE_SCOPE("raster setup");
+        for (size_t i = begin; i < end; i++) {
+            uint32_t first = (uint32_t)i * RASTER_BIN_TRIANGLES;
+            SetupTriangles(m_Bins[i], mesh, firstIndex, first, std::min(first + RASTER_BIN_TRIANGLES, triangleCount));
+        }
+    });
+    Clock::time_point binned = Clock::now();
+
+    uint32_t tileCount = m_TilesX * m_TilesY;
+    jobs.ParallelFor(tileCount, 1, [&](size_t begin, size_t end) {
+        PROFILE_SCOPE("raster tiles");
+        for (size_t tile = begin; tile < end; tile++) RasterizeTile((uint32_t)tile);
+    });
+    Clock::time_point rasterized = Clock::now();
+
+    m_Stats.triangles += triangleCount;
+    for (size_t i = 0; i < m_BinCount; i++) m_Stats.setupTriangles += m_Bins[i].triangles.size();
+    for (uint32_t tile = 0; tile < tileCount; tile++) {
+        m_Stats.pixelsTested += m_TileTested[tile];
+        m_Stats.pixelsWritten += m_TileWritten[tile];
+    }
+    m_Stats.vertexMs += std::chrono::duration<double, std::milli>(shaded - start).count();
+    m_Stats.binningMs += std::chrono::duration<double, std::milli>(binned - shaded).count();
+    m_Stats.rasterMs += std::chrono::duration<double, std::milli>(rasterized - binned).count();
+}
+
+void SoftwareRasterizer::ShadeVertices(const MeshFile& mesh, const Mat4& model, const Mat4& modelViewProjection, size_t begin, size_t end) {
+    const MeshFileHeader& header = mesh.GetHeader();
+    const uint8_t* vertices = static_cast<const uint8_t*>(mesh.GetVertices());
+    const float* m = model.data;
+    float lightLength = sqrtf(LIGHT_DIR[0] * LIGHT_DIR[0] + LIGHT_DIR[1] * LIGHT_DIR[1] + LIGHT_DIR[2] * LIGHT_DIR[2]);
+
+    for (size_t v = begin; v < end; v++) {
+        const uint8_t* vertex = vertices + v * header.vertexStride;
+        float position[3], normal[3], uv[2];
+        mesh.DecodePosition((uint32_t)v, position);
+        if (header.vertexFormat == MESH_VERTEX_PACKED16) {
+            // meme decodage que Quantization.glsl
+            int16_t e[2];
+            uint16_t t[2];
+            memcpy(e, vertex + 8, sizeof(e));
+            memcpy(t, vertex + 12, sizeof(t));
+            float ex = std::max(e[0] / 32767.0f, -1.0f), ey = std::max(e[1] / 32767.0f, -1.0f);
+            normal[2] = 1.0f - fabsf(ex) - fabsf(ey);
+            float fold = std::max(-normal[2], 0.0f);
+            normal[0] = ex + (ex >= 0.0f ? -fold : fold);
+            normal[1] = ey + (ey >= 0.0f ? -fold : fold);
+            uv[0] = t[0] / 65535.0f;
+            uv[1] = t[1] / 65535.0f;
+        } else {
+            float f[8];
+            memcpy(f, vertex, sizeof(f));
+            memcpy(normal, f + 3, sizeof(normal));
+            memcpy(uv, f + 6, sizeof(uv));
+        }
+
+        Vec4 clip = transformVec4(modelViewProjection, { position[0], position[1], position[2], 1.0f });
+
+        // normale en repere monde (mat3(model)), puis diffus de Lighting.glsl
+        float n[3];
+        for (int k = 0; k < 3; k++) n[k] = m[k] * normal[0] + m[4 + k] * normal[1] + m[8 + k] * normal[2];
+        float length = sqrtf(n[0] * n[0] + n[1] * n[1] + n[2] * n[2]);
+        float diffuse = 0.0f;
+        if (length > 0.0f) diffuse = std::max((n[0] * LIGHT_DIR[0] + n[1] * LIGHT_DIR[1] + n[2] * LIGHT_DIR[2]) / (length * lightLength), 0.0f);
+        float light = 0.2f + 0.8f * diffuse;
+
+        ClipVertex& out = m_Vertices[v];
+        out.x = clip.x;
+        out.y = clip.y;
+        out.z = clip.z;
+        out.w = clip.w;
+        out.r = (0.35f + 0.3f * uv[0]) * light;
+        out.g = 0.55f * light;
+        out.b = (0.35f + 0.3f * uv[1]) * light;
+    }
+}
+
+void SoftwareRasterizer::SetupTriangles(Bin& bin, const MeshFile& mesh, uint32_t firstIndex, uint32_t first, uint32_t last) {
+    const MeshFileHeader& header = mesh.GetHeader();
+    const void* indices = mesh.GetIndices();
+    auto index = [&](uint32_t i) -> uint32_t {
+        return header.indexSize == 2 ? static_cast<const uint16_t*>(indices)[i] : static_cast<const uint32_t*>(indices)[i];
+    };
+
+    bin.triangles.clear();
+    for (std::vector<uint32_t>& tile : bin.tiles) tile.clear();
+
+    for (uint32_t t = first; t < last; t++) {
+        const ClipVertex& a = m_Vertices[index(firstIndex + t * 3)];
+        const ClipVertex& b = m_Vertices[index(firstIndex + t * 3 + 1)];
+        const ClipVertex& c = m_Vertices[index(firstIndex + t * 3 + 2)];
+
+        // rejet quand les trois vertex sont du meme cote d'un plan du frustum
+        auto outcode = [](const ClipVertex& v) {
+            return (v.x < -v.w ? 1u : 0u) | (v.x > v.w ? 2u : 0u) | (v.y < -v.w ? 4u : 0u) |
+                (v.y > v.w ? 8u : 0u) | (v.z < -v.w ? 16u : 0u) | (v.z > v.w ? 32u : 0u);
+        };
+        if (outcode(a) & outcode(b) & outcode(c)) continue;
+        ClipTriangle(bin, a, b, c);
+    }
+}
+
+void SoftwareRasterizer::ClipTriangle(Bin& bin, const ClipVertex& a, const ClipVertex& b, const ClipVertex& c) {
+    // plan proche (z >= -w) et bande de garde en x et y ; le plan lointain est laisse au test de profondeur
+    float guardX = (RASTER_GUARD_BAND - 1) / (0.5f * m_Width);
+    float guardY = (RASTER_GUARD_BAND - 1) / (0.5f * m_Height);
+    auto distance = [guardX, guardY](const ClipVertex& v, int plane) {
+        switch (plane) {
+        case 0: return v.z + v.w;
+        case 1: return guardX * v.w - v.x;
+        case 2: return guardX * v.w + v.x;
+        case 3: return guardY * v.w - v.y;
+        default: return guardY * v.w + v.y;
+        }
+    };
+
+    uint32_t mask = 0;
+    for (const ClipVertex* v : { &a, &b, &c })
+        for (int plane = 0; plane < 5; plane++)
+            if (distance(*v, plane) < 0.0f) mask |= 1u << plane;
+    if (mask == 0) {
+        const ClipVertex* triangle[3] = { &a, &b, &c };
+        EmitTriangle(bin, triangle);
+        return;
+    }
+
+    // Sutherland-Hodgman : chaque plan ajoute au plus un sommet
+    ClipVertex buffers[2][8];
+    ClipVertex* input = buffers[0];
+    ClipVertex* output = buffers[1];
+    int count = 3;
+    input[0] = a;
+    input[1] = b;
+    input[2] = c;
+    for (int plane = 0; plane < 5 && count >= 3; plane++) {
+        if (!(mask & (1u << plane))) continue;
+        int outputCount = 0;
+        for (int i = 0; i < count; i++) {
+            const ClipVertex& p = input[i];
+            const ClipVertex& q = input[(i + 1) % count];
+            float dp = distance(p, plane), dq = distance(q, plane);
+            if (dp >= 0.0f) output[outputCount++] = p;
+            if ((dp >= 0.0f) != (dq >= 0.0f)) {
+                float s = dp / (dp - dq);
+                ClipVertex& v = output[outputCount++];
+                v.x = p.x + s * (q.x - p.x);
+                v.y = p.y + s * (q.y - p.y);
+                v.z = p.z + s * (q.z - p.z);
+                v.w = p.w + s * (q.w - p.w);
+                v.r = p.r + s * (q.r - p.r);
+                v.g = p.g + s * (q.g - p.g);
+                v.b = p.b + s * (q.b - p.b);
+            }
+        }
+        std::swap(input, output);
+        count = outputCount;
+    }
+
+    for (int i = 1; i + 1 < count; i++) {
+        const ClipVertex* triangle[3] = { &input[0], &input[i], &input[i + 1] };
+        EmitTriangle(bin, triangle);
+    }
+}
+
+void SoftwareRasterizer::EmitTriangle(Bin& bin, const ClipVertex* vertices[3]) {
+    // coordonnees ecran en sous-pixels relatives au centre de l'image, y vers le bas
+    int32_t x[3], y[3];
+    float attributes[3][5];
+    float halfWidth = 0.5f * m_Width, halfHeight = 0.5f * m_Height;
+    for (int k = 0; k < 3; k++) {
+        const ClipVertex& v = *vertices[k];
+        float invW = 1.0f / v.w;
+        x[k] = (int32_t)lrintf(v.x * invW * halfWidth * RASTER_SUBPIXEL);
+        y[k] = (int32_t)lrintf(-v.y * invW * halfHeight * RASTER_SUBPIXEL);
+        attributes[k][0] = v.z * invW * 0.5f + 0.5f;
+        attributes[k][1] = invW;
+        attributes[k][2] = v.r * invW;
+        attributes[k][3] = v.g * invW;
+        attributes[k][4] = v.b * invW;
+    }
+
+    // double de l'aire, positif quand les aretes sont orientees vers l'interieur ; sinon on inverse (pas de culling des faces arriere, comme le GL)
+    int64_t area = (int64_t)(x[1] - x[0]) * (y[2] - y[0]) - (int64_t)(x[2] - x[0]) * (y[1] - y[0]);
+    if (area == 0) return;
+    if (area < 0) {
+        std::swap(x[1], x[2]);
+        std::swap(y[1], y[2]);
+        std::swap(attributes[1], attributes[2]);
+        area = -area;
+    }
+
+    // pixels dont le centre (16 i + 8 - 8 largeur en sous-pixels) tombe dans la boite du triangle
+    int32_t originX = (int32_t)(m_Width * RASTER_SUBPIXEL / 2) - RASTER_SUBPIXEL / 2;
+    int32_t originY = (int32_t)(m_Height * RASTER_SUBPIXEL / 2) - RASTER_SUBPIXEL / 2;
+    SetupTriangle triangle;
+    triangle.minX = std::max(-floorDiv(-(std::min({ x[0], x[1], x[2] }) + originX), RASTER_SUBPIXEL), 0);
+    triangle.minY = std::max(-floorDiv(-(std::min({ y[0], y[1], y[2] }) + originY), RASTER_SUBPIXEL), 0);
+    triangle.maxX = std::min(floorDiv(std::max({ x[0], x[1], x[2] }) + originX, RASTER_SUBPIXEL), (int32_t)m_Width - 1);
+    triangle.maxY = std::min(floorDiv(std::max({ y[0], y[1], y[2] }) + originY, RASTER_SUBPIXEL), (int32_t)m_Height - 1);
+    if (triangle.minX > triangle.maxX || triangle.minY > triangle.maxY) return;
+
+    // arete k opposee au sommet k ; un pixel exactement sur une arete n'est couvert que pour les aretes haut-gauche
+    for (int k = 0; k < 3; k++) {
+        int i = (k + 1) % 3, j = (k + 2) % 3;
+        int32_t edgeA = y[i] - y[j];
+        int32_t edgeB = x[j] - x[i];
+        bool topLeft = edgeA > 0 || (edgeA == 0 && edgeB > 0);
+        triangle.edgeA[k] = edgeA;
+        triangle.edgeB[k] = edgeB;
+        triangle.edgeC[k] = (int32_t)((int64_t)x[i] * y[j] - (int64_t)y[i] * x[j]) - (topLeft ? 0 : 1);
+    }
+
+    // plans des attributs en pixels, depuis les positions arrondies pour coller a la couverture
+    float px[3], py[3];
+    for (int k = 0; k < 3; k++) {
+        px[k] = (float)x[k] / RASTER_SUBPIXEL;
+        py[k] = (float)y[k] / RASTER_SUBPIXEL;
+    }
+    float invArea = (float)(RASTER_SUBPIXEL * RASTER_SUBPIXEL) / (float)area;
+    float startX = triangle.minX + 0.5f - halfWidth - px[0];
+    float startY = triangle.minY + 0.5f - halfHeight - py[0];
+    for (int a = 0; a < 5; a++) {
+        float d1 = attributes[1][a] - attributes[0][a];
+        float d2 = attributes[2][a] - attributes[0][a];
+        float dx = (d1 * (py[2] - py[0]) - d2 * (py[1] - py[0])) * invArea;
+        float dy = (d2 * (px[1] - px[0]) - d1 * (px[2] - px[0])) * invArea;
+        triangle.planes[a][0] = attributes[0][a] + dx * startX + dy * startY;
+        triangle.planes[a][1] = dx;
+        triangle.planes[a][2] = dy;
+    }
+
+    uint32_t index = (uint32_t)bin.triangles.size();
+    bin.triangles.push_back(triangle);
+    for (int32_t ty = triangle.minY / (int32_t)RASTER_TILE_SIZE; ty <= triangle.maxY / (int32_t)RASTER_TILE_SIZE; ty++)
+        for (int32_t tx = triangle.minX / (int32_t)RASTER_TILE_SIZE; tx <= triangle.maxX / (int32_t)RASTER_TILE_SIZE; tx++)
+            bin.tiles[ty * m_TilesX + tx].push_back(index);
+}
+
+void SoftwareRasterizer::RasterizeTile(uint32_t tile) {
+    int32_t tileX0 = (int32_t)((tile % m_TilesX) * RASTER_TILE_SIZE);
+    int32_t tileY0 = (int32_t)((tile / m_TilesX) * RASTER_TILE_SIZE);
+    int32_t tileX1 = std::min(tileX0 + (int32_t)RASTER_TILE_SIZE, (int32_t)m_Width) - 1;
+    int32_t tileY1 = std::min(tileY0 + (int32_t)RASTER_TILE_SIZE, (int32_t)m_Height) - 1;
+    int32_t originX = (int32_t)(m_Width * RASTER_SUBPIXEL / 2) - RASTER_SUBPIXEL / 2;
+    int32_t originY = (int32_t)(m_Height * RASTER_SUBPIXEL / 2) - RASTER_SUBPIXEL / 2;
+    uint64_t tested = 0, written = 0;
+
+    for (size_t b = 0; b < m_BinCount; b++) {
+        const Bin& bin = m_Bins[b];
+        for (uint32_t index : bin.tiles[tile]) {
+            const SetupTriangle& triangle = bin.triangles[index];
+            // groupes de 4 pixels alignes : la ligne est completee jusqu'au multiple de 4 (m_Stride)
+            int32_t x0 = std::max(triangle.minX, tileX0) & ~3;
+            int32_t x1 = std::min(triangle.maxX, tileX1);
+            int32_t y0 = std::max(triangle.minY, tileY0);
+            int32_t y1 = std::min(triangle.maxY, tileY1);
+            const float* z = triangle.planes[0];
+            const float* w = triangle.planes[1];
+            const float* r = triangle.planes[2];
+            const float* g = triangle.planes[3];
+            const float* bl = triangle.planes[4];
+            int32_t sampleX = x0 * RASTER_SUBPIXEL - originX;
+
+#if defined(MATH_SIMD_SSE)
+            const __m128i laneOffsets = _mm_setr_epi32(0, 1, 2, 3);
+            const __m128 one = _mm_set1_ps(1.0f);
+            const __m128 zero = _mm_setzero_ps();
+            const __m128 scale = _mm_set1_ps(255.0f);
+            const __m128 half = _mm_set1_ps(0.5f);
+            const __m128i alpha = _mm_set1_epi32((int)0xFF000000u);
+            __m128i laneStep[3], groupStep[3];
+            for (int k = 0; k < 3; k++) {
+                int32_t step = triangle.edgeA[k] * RASTER_SUBPIXEL;
+                laneStep[k] = _mm_setr_epi32(0, step, step * 2, step * 3);
+                groupStep[k] = _mm_set1_epi32(step * 4);
+            }
+            for (int32_t py = y0; py <= y1; py++) {
+                int32_t sampleY = py * RASTER_SUBPIXEL - originY;
+                __m128i edge[3];
+                for (int k = 0; k < 3; k++)
+                    edge[k] = _mm_add_epi32(_mm_set1_epi32(triangle.edgeA[k] * sampleX + triangle.edgeB[k] * sampleY + triangle.edgeC[k]), laneStep[k]);
+                float fy = (float)(py - triangle.minY);
+                __m128 zRow = _mm_set1_ps(z[0] + z[2] * fy), wRow = _mm_set1_ps(w[0] + w[2] * fy);
+                __m128 rRow = _mm_set1_ps(r[0] + r[2] * fy), gRow = _mm_set1_ps(g[0] + g[2] * fy), bRow = _mm_set1_ps(bl[0] + bl[2] * fy);
+                float* depthRow = &m_Depth[(size_t)py * m_Stride];
+                uint32_t* colorRow = &m_Color[(size_t)py * m_Stride];
+                for (int32_t px = x0; px <= x1; px += 4) {
+                    // interieur : les trois fonctions d'arete >= 0, soit le bit de signe de leur OU a 0
+                    __m128i inside = _mm_cmpgt_epi32(_mm_or_si128(_mm_or_si128(edge[0], edge[1]), edge[2]), _mm_set1_epi32(-1));
+                    int covered = _mm_movemask_ps(_mm_castsi128_ps(inside));
+                    if (covered) {
+                        __m128 fx = _mm_cvtepi32_ps(_mm_add_epi32(_mm_set1_epi32(px - triangle.minX), laneOffsets));
+                        __m128 depth = _mm_add_ps(zRow, _mm_mul_ps(_mm_set1_ps(z[1]), fx));
+                        __m128 stored = _mm_loadu_ps(depthRow + px);
+                        __m128 pass = _mm_and_ps(_mm_castsi128_ps(inside), _mm_cmplt_ps(depth, stored));
+                        int passed = _mm_movemask_ps(pass);
+                        tested += LANE_COUNT[covered];
+                        if (passed) {
+                            written += LANE_COUNT[passed];
+                            _mm_storeu_ps(depthRow + px, _mm_or_ps(_mm_and_ps(pass, depth), _mm_andnot_ps(pass, stored)));
+                            // correction de perspective : attributs / w interpoles, divises par 1 / w interpole
+                            __m128 invW = _mm_div_ps(one, _mm_add_ps(wRow, _mm_mul_ps(_mm_set1_ps(w[1]), fx)));
+                            __m128 cr = _mm_mul_ps(_mm_add_ps(rRow, _mm_mul_ps(_mm_set1_ps(r[1]), fx)), invW);
+                            __m128 cg = _mm_mul_ps(_mm_add_ps(gRow, _mm_mul_ps(_mm_set1_ps(g[1]), fx)), invW);
+                            __m128 cb = _mm_mul_ps(_mm_add_ps(bRow, _mm_mul_ps(_mm_set1_ps(bl[1]), fx)), invW);
+                            __m128i ir = _mm_cvttps_epi32(_mm_add_ps(_mm_mul_ps(_mm_min_ps(_mm_max_ps(cr, zero), one), scale), half));
+                            __m128i ig = _mm_cvttps_epi32(_mm_add_ps(_mm_mul_ps(_mm_min_ps(_mm_max_ps(cg, zero), one), scale), half));
+                            __m128i ib = _mm_cvttps_epi32(_mm_add_ps(_mm_mul_ps(_mm_min_ps(_mm_max_ps(cb, zero), one), scale), half));
+                            __m128i color = _mm_or_si128(_mm_or_si128(ir, _mm_slli_epi32(ig, 8)), _mm_or_si128(_mm_slli_epi32(ib, 16), alpha));
+                            __m128i passMask = _mm_castps_si128(pass);
+                            __m128i old = _mm_loadu_si128(reinterpret_cast<const __m128i*>(colorRow + px));
+                            _mm_storeu_si128(reinterpret_cast<__m128i*>(colorRow + px), _mm_or_si128(_mm_and_si128(passMask, color), _mm_andnot_si128(passMask, old)));
+                        }
+                    }
+                    for (int k = 0; k < 3; k++) edge[k] = _mm_add_epi32(edge[k], groupStep[k]);
+                }
+            }
+#elif defined(MATH_SIMD_NEON)
+            const int32_t laneIndices[4] = { 0, 1, 2, 3 };
+            const uint32_t laneBits[4] = { 1, 2, 4, 8 };
+            const int32x4_t laneOffsets = vld1q_s32(laneIndices);
+            const uint32x4_t laneMask = vld1q_u32(laneBits);
+            const float32x4_t one = vdupq_n_f32(1.0f);
+            const float32x4_t zero = vdupq_n_f32(0.0f);
+            const float32x4_t scale = vdupq_n_f32(255.0f);
+            const float32x4_t half = vdupq_n_f32(0.5f);
+            const uint32x4_t alpha = vdupq_n_u32(0xFF000000u);
+            int32x4_t laneStep[3], groupStep[3];
+            for (int k = 0; k < 3; k++) {
+                int32_t step = triangle.edgeA[k] * RASTER_SUBPIXEL;
+                laneStep[k] = vmulq_n_s32(laneOffsets, step);
+                groupStep[k] = vdupq_n_s32(step * 4);
+            }
+            for (int32_t py = y0; py <= y1; py++) {
+                int32_t sampleY = py * RASTER_SUBPIXEL - originY;
+                int32x4_t edge[3];
+                for (int k = 0; k < 3; k++)
+                    edge[k] = vaddq_s32(vdupq_n_s32(triangle.edgeA[k] * sampleX + triangle.edgeB[k] * sampleY + triangle.edgeC[k]), laneStep[k]);
+                float fy = (float)(py - triangle.minY);
+                float32x4_t zRow = vdupq_n_f32(z[0] + z[2] * fy), wRow = vdupq_n_f32(w[0] + w[2] * fy);
+                float32x4_t rRow = vdupq_n_f32(r[0] + r[2] * fy), gRow = vdupq_n_f32(g[0] + g[2] * fy), bRow = vdupq_n_f32(bl[0] + bl[2] * fy);
+                float* depthRow = &m_Depth[(size_t)py * m_Stride];
+                uint32_t* colorRow = &m_Color[(size_t)py * m_Stride];
+                for (int32_t px = x0; px <= x1; px += 4) {
+                    uint32x4_t inside = vcgeq_s32(vorrq_s32(vorrq_s32(edge[0], edge[1]), edge[2]), vdupq_n_s32(0));
+                    uint32_t covered = vaddvq_u32(vandq_u32(inside, laneMask));
+                    if (covered) {
+                        float32x4_t fx = vcvtq_f32_s32(vaddq_s32(vdupq_n_s32(px - triangle.minX), laneOffsets));
+                        float32x4_t depth = vaddq_f32(zRow, vmulq_n_f32(fx, z[1]));
+                        float32x4_t stored = vld1q_f32(depthRow + px);
+                        uint32x4_t pass = vandq_u32(inside, vcltq_f32(depth, stored));
+                        uint32_t passed = vaddvq_u32(vandq_u32(pass, laneMask));
+                        tested += LANE_COUNT[covered];
+                        if (passed) {
+                            written += LANE_COUNT[passed];
+                            vst1q_f32(depthRow + px, vbslq_f32(pass, depth, stored));
+                            float32x4_t invW = vdivq_f32(one, vaddq_f32(wRow, vmulq_n_f32(fx, w[1])));
+                            float32x4_t cr = vmulq_f32(vaddq_f32(rRow, vmulq_n_f32(fx, r[1])), invW);
+                            float32x4_t cg = vmulq_f32(vaddq_f32(gRow, vmulq_n_f32(fx, g[1])), invW);
+                            float32x4_t cb = vmulq_f32(vaddq_f32(bRow, vmulq_n_f32(fx, bl[1])), invW);
+                            uint32x4_t ir = vcvtq_u32_f32(vaddq_f32(vmulq_f32(vminq_f32(vmaxq_f32(cr, zero), one), scale), half));
+                            uint32x4_t ig = vcvtq_u32_f32(vaddq_f32(vmulq_f32(vminq_f32(vmaxq_f32(cg, zero), one), scale), half));
+                            uint32x4_t ib = vcvtq_u32_f32(vaddq_f32(vmulq_f32(vminq_f32(vmaxq_f32(cb, zero), one), scale), half));
+                            uint32x4_t color = vorrq_u32(vorrq_u32(ir, vshlq_n_u32(ig, 8)), vorrq_u32(vshlq_n_u32(ib, 16), alpha));
+                            vst1q_u32(colorRow + px, vbslq_u32(pass, color, vld1q_u32(colorRow + px)));
+                        }
+                    }
+                    for (int k = 0; k < 3; k++) edge[k] = vaddq_s32(edge[k], groupStep[k]);
+                }
+            }
+#else
+            for (int32_t py = y0; py <= y1; py++) {
+                int32_t sampleY = py * RASTER_SUBPIXEL - originY;
+                int32_t edge[3];
+                for (int k = 0; k < 3; k++) edge[k] = triangle.edgeA[k] * sampleX + triangle.edgeB[k] * sampleY + triangle.edgeC[k];
+                float fy = (float)(py - triangle.minY);
+                float zRow = z[0] + z[2] * fy, wRow = w[0] + w[2] * fy;
+                float rRow = r[0] + r[2] * fy, gRow = g[0] + g[2] * fy, bRow = bl[0] + bl[2] * fy;
+                float* depthRow = &m_Depth[(size_t)py * m_Stride];
+                uint32_t* colorRow = &m_Color[(size_t)py * m_Stride];
+                // meme parcours par groupes de 4 que les versions SIMD
+                for (int32_t px = x0; px < ((x1 + 4) & ~3); px++) {
+                    if ((edge[0] | edge[1] | edge[2]) >= 0) {
+                        float fx = (float)(px - triangle.minX);
+                        float depth = zRow + z[1] * fx;
+                        tested++;
+                        if (depth < depthRow[px]) {
+                            written++;
+                            depthRow[px] = depth;
+                            float invW = 1.0f / (wRow + w[1] * fx);
+                            auto channel = [invW, fx](float row, float slope) {
+                                return (uint32_t)(std::min(std::max((row + slope * fx) * invW, 0.0f), 1.0f) * 255.0f + 0.5f);
+                            };
+                            colorRow[px] = channel(rRow, r[1]) | (channel(gRow, g[1]) << 8) | (channel(bRow, bl[1]) << 16) | 0xFF000000u;
+                        }
+                    }
+                    for (int k = 0; k < 3; k++) edge[k] += triangle.edgeA[k] * RASTER_SUBPIXEL;
+                }
+            }
+#endif
+        }
+    }
+
+    m_TileTested[tile] = tested;
+    m_TileWritten[tile] = written;
+}
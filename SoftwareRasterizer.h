@@ -0,0 +1,89 @@
+#pragma once
+
+#include "MathUtils.h"
+#include "MeshFile.h"
+#include "JobSystem.h"
+#include <cstdint>
+#include <cstddef>
+#include <vector>
+
+// rasteriseur logiciel par tuiles, pour valider le rendu sur les machines sans GPU :
+// vertex transformes et eclaires en parallele, triangles decoupes au plan proche et a la bande de garde
+// puis ranges par tuile, chaque tuile rasterisee par un job (fonctions d'arete entieres, 4 pixels a la fois)
+const uint32_t RASTER_TILE_SIZE = 64;
+const uint32_t RASTER_SUBPIXEL_BITS = 4;
+const uint32_t RASTER_GUARD_BAND = 1024;      // pixels de part et d'autre du centre : fonctions d'arete sur 32 bits
+const uint32_t RASTER_MAX_SIZE = 2 * (RASTER_GUARD_BAND - 16);
+const uint32_t RASTER_BIN_TRIANGLES = 1024;   // triangles prepares par job
+
+// compteurs cumules depuis le dernier ResetStats
+struct RasterStats {
+    uint64_t triangles;        // triangles soumis
+    uint64_t setupTriangles;   // apres rejet hors champ et decoupage
+    uint64_t pixelsTested;     // pixels couverts soumis au test de profondeur
+    uint64_t pixelsWritten;    // pixels qui l'ont passe
+    double vertexMs;
+    double binningMs;
+    double rasterMs;
+};
+
+class SoftwareRasterizer {
+public:
+    SoftwareRasterizer();
+
+    bool Create(uint32_t width, uint32_t height);
+
+    // color en RGBA8 (R dans l'octet de poids faible), profondeur remise a 1
+    void Clear(uint32_t color);
+
+    // indexCount index a partir de firstIndex, vertex et index lus tels quels dans le fichier mappe (float ou
+    // compresses), memes matrices que le rendu GL ; les deux faces sont dessinees, test de profondeur GL_LESS
+    void DrawMesh(JobSystem& jobs, const MeshFile& mesh, uint32_t firstIndex, uint32_t indexCount, const Mat4& model, const Mat4& viewProjection);
+
+    uint32_t GetWidth() const { return m_Width; }
+    uint32_t GetHeight() const { return m_Height; }
+    // premiere ligne en haut de l'image
+    const uint32_t* GetColor() const { return m_Color.data(); }
+    size_t GetRowPitch() const { return m_Stride * sizeof(uint32_t); }
+
+    const RasterStats& GetStats() const { return m_Stats; }
+    void ResetStats() { m_Stats = {}; }
+
+private:
+    // sortie de l'etage vertex : position de clipping et couleur eclairee
+    struct ClipVertex {
+        float x, y, z, w;
+        float r, g, b;
+    };
+
+    // E = A X + B Y + C sur les centres de pixels en sous-pixels, >= 0 a l'interieur (regle haut-gauche incluse)
+    // plans : z, 1/w, r/w, g/w, b/w, chacun valeur au pixel (minX, minY) puis pentes en x et en y
+    struct SetupTriangle {
+        int32_t edgeA[3], edgeB[3], edgeC[3];
+        float planes[5][3];
+        int32_t minX, minY, maxX, maxY;   // pixels, bornes incluses
+    };
+
+    // triangles prepares par un job, et pour chaque tuile les indices de ceux qui la touchent
+    struct Bin {
+        std::vector<SetupTriangle> triangles;
+        std::vector<std::vector<uint32_t>> tiles;
+    };
+
+    uint32_t m_Width, m_Height;
+    uint32_t m_Stride;   // pixels par ligne, multiple de 4
+    uint32_t m_TilesX, m_TilesY;
+    std::vector<uint32_t> m_Color;
+    std::vector<float> m_Depth;
+    std::vector<ClipVertex> m_Vertices;
+    std::vector<Bin> m_Bins;
+    size_t m_BinCount;
+    std::vector<uint64_t> m_TileTested, m_TileWritten;
+    RasterStats m_Stats;
+
+    void ShadeVertices(const MeshFile& mesh, const Mat4& model, const Mat4& modelViewProjection, size_t begin, size_t end);
+    void SetupTriangles(Bin& bin, const MeshFile& mesh, uint32_t firstIndex, uint32_t first, uint32_t last);
+    void ClipTriangle(Bin& bin, const ClipVertex& a, const ClipVertex& b, const ClipVertex& c);
+    void EmitTriangle(Bin& bin, const ClipVertex* vertices[3]);
+    void RasterizeTile(uint32_t tile);
+};
@@ -0,0 +1,13 @@
+#include "UniformBuffer.h"
+#include <GL/glew.h>
+#include <GL/gl.h>
+#include <cstddef>
+
+static_assert(offsetof(CameraBlock, viewProjection) == 128 && offsetof(CameraBlock, time) == 192, "CameraBlock doit suivre la disposition std140");
+static_assert(sizeof(ObjectBlock) == 64, "ObjectBlock doit suivre la disposition std140");
+
+size_t getUniformOffsetAlignment() {
+    GLint alignment = 256;
+    glGetIntegerv(GL_UNIFORM_BUFFER_OFFSET_ALIGNMENT, &alignment);
+    return alignment > 0 ? (size_t)alignment : 256;
+}
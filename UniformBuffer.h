@@ -0,0 +1,25 @@
+#pragma once
+
+#include "MathUtils.h"
+#include <cstdint>
+#include <cstddef>
+
+// points de liaison des blocs uniformes partages par tous les shaders
+const uint32_t CAMERA_BLOCK_BINDING = 0;
+const uint32_t OBJECT_BLOCK_BINDING = 1;
+
+// miroirs C++ des blocs std140 declares dans les shaders
+struct CameraBlock {
+    Mat4 view;
+    Mat4 projection;
+    Mat4 viewProjection;
+    float time;
+    float padding[3];
+};
+
+struct ObjectBlock {
+    Mat4 model;
+};
+
+// alignement minimal des offsets passes a glBindBufferRange (GL_UNIFORM_BUFFER_OFFSET_ALIGNMENT)
+size_t getUniformOffsetAlignment();